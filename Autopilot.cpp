@@ -0,0 +1,146 @@
+#include "Autopilot.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// Constructor
+//
+Autopilot::Autopilot(
+    const int beamWidth,
+    const int depth,
+    const int ticksPerPly,
+    const double tickSeconds)
+: Autopilot(beamWidth, depth, ticksPerPly, tickSeconds, std::pmr::get_default_resource())
+{
+}
+
+
+// Constructor
+//
+Autopilot::Autopilot(
+    const int beamWidth,
+    const int depth,
+    const int ticksPerPly,
+    const double tickSeconds,
+    std::pmr::memory_resource* resource)
+: m_beamWidth(std::max(beamWidth, 1)),
+  m_depth(std::max(depth, 1)),
+  m_ticksPerPly(std::max(ticksPerPly, 1)),
+  m_tickSeconds(tickSeconds),
+  m_nodesExpanded(0),
+  m_beam(resource),
+  m_candidates(resource)
+{
+    // Both buffers are sized once so decide() never allocates
+    m_beam.reserve(m_beamWidth);
+    m_candidates.reserve(m_beamWidth * 2);
+}
+
+
+// Decide
+//
+bool Autopilot::decide(const GameState& state, const GameParameters& parameters)
+{
+    m_beam.clear();
+
+    Node root;
+    root.m_state = state;
+    root.m_value = 0.0;
+    root.m_firstJump = false;
+    m_beam.push_back(root);
+
+    for (int ply = 0; ply < m_depth; ++ply)
+    {
+        m_candidates.clear();
+
+        for (const Node& parent : m_beam)
+        {
+            if (!parent.m_state.m_running)
+            {
+                // Dead lines keep their value but are not expanded
+                m_candidates.push_back(parent);
+                continue;
+            }
+
+            for (const bool jump : { false, true })
+            {
+                m_candidates.push_back(parent);
+                Node& child = m_candidates.back();
+
+                if (ply == 0)
+                {
+                    child.m_firstJump = jump;
+                }
+
+                for (int tick = 0; tick < m_ticksPerPly && child.m_state.m_running; ++tick)
+                {
+                    Simulation::step(child.m_state, parameters, jump && tick == 0, m_tickSeconds);
+                }
+
+                child.m_value = this->evaluate(child.m_state, parameters, ply);
+                ++m_nodesExpanded;
+            }
+        }
+
+        // Keep the best beamWidth candidates
+        const size_t keep = std::min(m_candidates.size(), static_cast<size_t>(m_beamWidth));
+
+        std::partial_sort(
+            m_candidates.begin(),
+            m_candidates.begin() + keep,
+            m_candidates.end(),
+            [](const Node& lhs, const Node& rhs) { return lhs.m_value > rhs.m_value; });
+
+        m_beam.assign(m_candidates.begin(), m_candidates.begin() + keep);
+    }
+
+    return m_beam.front().m_firstJump;
+}
+
+
+// Tick Seconds
+// Accessor for m_tickSeconds
+//
+double Autopilot::tickSeconds(void) const
+{
+    return m_tickSeconds;
+}
+
+
+// Nodes Expanded
+// Accessor for m_nodesExpanded
+//
+uint64_t Autopilot::nodesExpanded(void) const
+{
+    return m_nodesExpanded;
+}
+
+
+// Evaluate
+// Survival dominates, then score, then distance from the next gap centre.
+//
+double Autopilot::evaluate(const GameState& state, const GameParameters& parameters, const int ply) const
+{
+    if (!state.m_running)
+    {
+        // Dying later is better than dying sooner
+        return -1.0e9 + (ply * 1.0e6);
+    }
+
+    double value = static_cast<double>(state.m_score) * 1.0e3;
+
+    const Pipe* pipe = Simulation::nextPipe(state);
+
+    if (pipe != nullptr)
+    {
+        const double gapCenter = pipe->m_gapStartRow + ((pipe->m_gapSize - 1) * 0.5);
+        value -= std::abs(state.m_rowDouble - gapCenter);
+    }
+    else
+    {
+        value -= std::abs(state.m_rowDouble - (parameters.m_height * 0.5));
+    }
+
+    return value;
+}
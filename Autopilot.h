@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+
+// Autopilot
+// Reference beam-search bot. Each ply either jumps or coasts for a few
+// fixed ticks; the best beamWidth lines survive to the next ply.
+//
+class Autopilot
+{
+public:
+    // Deleted Special Member Functions
+    //
+    Autopilot(void) = delete;
+    Autopilot(const Autopilot& RHS) = delete;
+    Autopilot(Autopilot&& RHS) = delete;
+    Autopilot& operator=(const Autopilot& RHS) = delete;
+    Autopilot& operator=(Autopilot&& RHS) = delete;
+
+    // Constructor
+    //
+    Autopilot(const int beamWidth, const int depth, const int ticksPerPly, const double tickSeconds);
+
+    // Constructor
+    // Beams come from the given resource, such as an episode's arena.
+    //
+    Autopilot(
+        const int beamWidth,
+        const int depth,
+        const int ticksPerPly,
+        const double tickSeconds,
+        std::pmr::memory_resource* resource);
+
+    // Destructor
+    //
+    ~Autopilot(void) = default;
+
+    // Decide
+    // Returns whether to jump now.
+    //
+    [[nodiscard]] bool decide(const GameState& state, const GameParameters& parameters);
+
+    // Accessors
+    //
+    [[nodiscard]] double tickSeconds(void) const;
+    [[nodiscard]] uint64_t nodesExpanded(void) const;
+
+private:
+    struct Node
+    {
+        GameState m_state;
+        double m_value = 0.0;
+        bool m_firstJump = false;
+    };
+
+    // Evaluate a leaf
+    //
+    [[nodiscard]] double evaluate(const GameState& state, const GameParameters& parameters, const int ply) const;
+
+    // Private Data Variables
+    //
+    int m_beamWidth;
+    int m_depth;
+    int m_ticksPerPly;
+    double m_tickSeconds;
+    uint64_t m_nodesExpanded;
+    std::pmr::vector<Node> m_beam;
+    std::pmr::vector<Node> m_candidates;
+};
@@ -0,0 +1,292 @@
+#include "BandedCompositor.h"
+#include "Scene.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+    // Big enough that a band's fixed costs (a task hand-out, a cursor move
+    // and a colour at its start) vanish, small enough that a large screen
+    // still splits into plenty of bands to share out
+    constexpr int CELLS_PER_BAND = 2048;
+
+    // An unchanged stretch this short is cheaper to send again than to
+    // jump the cursor over
+    constexpr int MAX_RESENT_GAP = 3;
+
+    static_assert(sizeof(CHAR_INFO) * 16 == 64, "A cell line must be one cache line");
+
+    bool sameCell(const CHAR_INFO& lhs, const CHAR_INFO& rhs)
+    {
+        return lhs.Attributes == rhs.Attributes && lhs.Char.UnicodeChar == rhs.Char.UnicodeChar;
+    }
+
+    // Writes a small non-negative number, returning the end
+    char* writeNumber(char* out, int value)
+    {
+        char digits[10];
+        int count = 0;
+
+        do
+        {
+            digits[count++] = static_cast<char>('0' + (value % 10));
+            value /= 10;
+        }
+        while (value > 0);
+
+        while (count > 0)
+        {
+            *out++ = digits[--count];
+        }
+
+        return out;
+    }
+
+    // Console attribute bits are blue, green, red, intensity; ANSI colour
+    // numbers are red, green, blue
+    int ansiColour(const int bits)
+    {
+        return ((bits & 0x4) ? 1 : 0) | ((bits & 0x2) ? 2 : 0) | ((bits & 0x1) ? 4 : 0);
+    }
+
+    char* writeColour(char* out, const WORD attributes)
+    {
+        const int foreground = attributes & 0xF;
+        const int background = (attributes >> 4) & 0xF;
+
+        *out++ = '\x1b';
+        *out++ = '[';
+        out = writeNumber(out, ((foreground & 0x8) ? 90 : 30) + ansiColour(foreground));
+        *out++ = ';';
+        out = writeNumber(out, ((background & 0x8) ? 100 : 40) + ansiColour(background));
+        *out++ = 'm';
+
+        return out;
+    }
+
+    char* writeCursor(char* out, const int row, const int col)
+    {
+        *out++ = '\x1b';
+        *out++ = '[';
+        out = writeNumber(out, row + 1);
+        *out++ = ';';
+        out = writeNumber(out, col + 1);
+        *out++ = 'H';
+
+        return out;
+    }
+
+    char* writeUtf8(char* out, const wchar_t character)
+    {
+        const uint32_t code = static_cast<uint16_t>(character);
+
+        if (code < 0x80)
+        {
+            *out++ = static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            *out++ = static_cast<char>(0xC0 | (code >> 6));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            *out++ = static_cast<char>(0xE0 | (code >> 12));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        }
+
+        return out;
+    }
+
+    // A cursor move, a colour and a character, with room to spare
+    constexpr size_t MAX_BYTES_PER_CELL = 48;
+}
+
+
+// Constructor
+//
+BandedCompositor::BandedCompositor(const int width, const int height, const int threadCount)
+: m_width(width),
+  m_height(height),
+  m_bands(),
+  m_pool(threadCount),
+  m_output()
+{
+    const int rowsPerBand = std::clamp((CELLS_PER_BAND + width - 1) / width, 1, std::max(height, 1));
+
+    for (int firstRow = 0; firstRow < height; firstRow += rowsPerBand)
+    {
+        Band& band = m_bands.emplace_back();
+        band.m_firstRow = firstRow;
+        band.m_lastRow = std::min(firstRow + rowsPerBand, height);
+
+        const size_t cells = static_cast<size_t>(band.m_lastRow - band.m_firstRow) * width;
+        const size_t cellLines = (cells + 15) / 16;
+        band.m_frames[0].resize(cellLines);
+        band.m_frames[1].resize(cellLines);
+
+        // About what a full repaint of plain cells takes; grows if not
+        band.m_encoded.resize(((cells * 4) / sizeof(ByteLine)) + 1);
+    }
+}
+
+
+// Compose
+//
+const std::string& BandedCompositor::compose(
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps)
+{
+    TRACE_SCOPE("BandedCompositor::compose");
+
+    m_pool.run(static_cast<int>(m_bands.size()), [&](const int index)
+    {
+        Band& band = m_bands[index];
+        this->composeBand(band, state, parameters, fps);
+        this->encodeBand(band);
+    });
+
+    // Deterministic merge: screen order, one buffer, one write
+    m_output.clear();
+
+    for (const Band& band : m_bands)
+    {
+        m_output.append(reinterpret_cast<const char*>(band.m_encoded.data()), band.m_encodedSize);
+    }
+
+    if (!m_output.empty())
+    {
+        m_output.append("\x1b[0m");
+    }
+
+    return m_output;
+}
+
+
+// Invalidate
+//
+void BandedCompositor::invalidate(void)
+{
+    for (Band& band : m_bands)
+    {
+        band.m_full = true;
+    }
+}
+
+
+// Band Count
+//
+int BandedCompositor::bandCount(void) const
+{
+    return static_cast<int>(m_bands.size());
+}
+
+
+// Thread Count
+//
+int BandedCompositor::threadCount(void) const
+{
+    return m_pool.threadCount();
+}
+
+
+// Compose Band
+//
+void BandedCompositor::composeBand(
+    Band& band,
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps) const
+{
+    CHAR_INFO* cells = band.m_frames[band.m_current].data()->m_cells;
+
+    Scene::composeRows(state, parameters, fps, band.m_firstRow, band.m_lastRow, cells);
+}
+
+
+// Encode Band
+// Walks each row for runs of changed cells. A run starts with a cursor
+// move and carries on over short unchanged gaps. The colour is only sent
+// when it changes, and always at the band's first run, since the band
+// before it may have left anything set.
+//
+void BandedCompositor::encodeBand(Band& band) const
+{
+    const CHAR_INFO* current = band.m_frames[band.m_current].data()->m_cells;
+    const CHAR_INFO* previous = band.m_frames[1 - band.m_current].data()->m_cells;
+    const bool full = band.m_full;
+
+    auto changed = [&](const size_t index) -> bool
+    {
+        return full || !sameCell(current[index], previous[index]);
+    };
+
+    band.m_encodedSize = 0;
+    int colour = -1;
+
+    for (int row = band.m_firstRow; row < band.m_lastRow; ++row)
+    {
+        const size_t rowStart = static_cast<size_t>(row - band.m_firstRow) * m_width;
+        int col = 0;
+
+        while (col < m_width)
+        {
+            if (!changed(rowStart + col))
+            {
+                ++col;
+                continue;
+            }
+
+            // Worst case for the rest of the row, so writes need no checks
+            const size_t capacity = band.m_encoded.size() * sizeof(ByteLine);
+            const size_t needed = band.m_encodedSize + ((m_width - col) * MAX_BYTES_PER_CELL);
+
+            if (needed > capacity)
+            {
+                band.m_encoded.resize(std::max(band.m_encoded.size() * 2, (needed / sizeof(ByteLine)) + 1));
+            }
+
+            char* const begin = reinterpret_cast<char*>(band.m_encoded.data()) + band.m_encodedSize;
+            char* out = writeCursor(begin, row, col);
+
+            while (col < m_width)
+            {
+                if (!changed(rowStart + col))
+                {
+                    int next = col + 1;
+
+                    while (next < m_width && next - col < MAX_RESENT_GAP && !changed(rowStart + next))
+                    {
+                        ++next;
+                    }
+
+                    if (next >= m_width || !changed(rowStart + next))
+                    {
+                        break;
+                    }
+                }
+
+                const CHAR_INFO& cell = current[rowStart + col];
+
+                if (cell.Attributes != colour)
+                {
+                    out = writeColour(out, cell.Attributes);
+                    colour = cell.Attributes;
+                }
+
+                out = writeUtf8(out, cell.Char.UnicodeChar);
+                ++col;
+            }
+
+            band.m_encodedSize += static_cast<size_t>(out - begin);
+        }
+    }
+
+    band.m_current = 1 - band.m_current;
+    band.m_full = false;
+}
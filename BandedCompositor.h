@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ConsoleEngine.hpp"
+#include "Simulation.h"
+#include "WorkerPool.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+// BandedCompositor
+// Composes and encodes frames for very large terminals by cutting the
+// screen into bands of whole rows that a persistent worker pool handles
+// in parallel. Each band composes its rows, compares them with what it
+// sent last frame, and encodes only the changed runs as VT escape
+// sequences. Bands keep their cells and bytes in storage of their own,
+// padded to whole cache lines, so no two workers ever write the same
+// line. The band outputs are then joined in screen order into one write,
+// so the bytes are the same whatever the thread count.
+//
+class BandedCompositor
+{
+public:
+    // Deleted Special Member Functions
+    //
+    BandedCompositor(void) = delete;
+    BandedCompositor(const BandedCompositor& RHS) = delete;
+    BandedCompositor(BandedCompositor&& RHS) = delete;
+    BandedCompositor& operator=(const BandedCompositor& RHS) = delete;
+    BandedCompositor& operator=(BandedCompositor&& RHS) = delete;
+
+    // Constructor
+    //
+    BandedCompositor(const int width, const int height, const int threadCount);
+
+    // Destructor
+    //
+    ~BandedCompositor(void) = default;
+
+    // Compose
+    // The VT bytes that bring the terminal from the last frame to this one.
+    //
+    [[nodiscard]] const std::string& compose(
+        const GameState& state,
+        const GameParameters& parameters,
+        const double fps);
+
+    // Invalidate
+    // Something else drew on the terminal; send every cell next frame.
+    //
+    void invalidate(void);
+
+    [[nodiscard]] int bandCount(void) const;
+    [[nodiscard]] int threadCount(void) const;
+
+private:
+    // Sixteen cells or 64 bytes, whichever is counted
+    struct alignas(64) CellLine
+    {
+        CHAR_INFO m_cells[16];
+    };
+
+    struct alignas(64) ByteLine
+    {
+        char m_bytes[64];
+    };
+
+    struct alignas(64) Band
+    {
+        int m_firstRow = 0;
+        int m_lastRow = 0;
+        int m_current = 0;                  // Which of m_frames is this frame
+        std::vector<CellLine> m_frames[2];  // This frame and the last one sent
+        std::vector<ByteLine> m_encoded;
+        size_t m_encodedSize = 0;
+        bool m_full = true;                 // Send every cell, not just changes
+    };
+
+    void composeBand(Band& band, const GameState& state, const GameParameters& parameters, const double fps) const;
+    void encodeBand(Band& band) const;
+
+    // Private Data Variables
+    //
+    int m_width;
+    int m_height;
+    std::vector<Band> m_bands;
+    WorkerPool m_pool;
+    std::string m_output;
+};
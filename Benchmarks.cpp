@@ -0,0 +1,1288 @@
+#include "Benchmarks.h"
+
+#include "Autopilot.h"
+#include "BandedCompositor.h"
+#include "Cpu.h"
+#include "EpisodeArena.h"
+#include "GameGrid.h"
+#include "Leaderboard.h"
+#include "Level.h"
+#include "Netplay.h"
+#include "OccupancyMap.h"
+#include "PixelCanvas.h"
+#include "Replay.h"
+#include "RewindHistory.h"
+#include "Rollback.h"
+#include "Scene.h"
+#include "ScrollingField.h"
+#include "Simulation.h"
+
+#include <psapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+    constexpr int STRESS_SUBMISSIONS_PER_WRITER = 20'000;
+
+    // Writer i submits the same scores every run, so the parent can work
+    // out the expected board on its own
+    uint32_t stressScore(Random& random)
+    {
+        return static_cast<uint32_t>(random.range(1, 1'000'000));
+    }
+
+    // A bot that flaps whenever it sinks below the middle of the gap, but
+    // hesitates now and then, and gives up after a while so rounds end
+    bool versusBotJump(const GameState& state, Random& random, const uint32_t tick)
+    {
+        constexpr uint32_t giveUpTick = 60 * 40;
+        const Pipe* pipe = Simulation::nextPipe(state);
+
+        if (!state.m_running || pipe == nullptr || tick > giveUpTick)
+        {
+            return false;
+        }
+
+        const double middle = pipe->m_gapStartRow + (pipe->m_gapSize * 0.5);
+
+        return state.m_rowDouble > middle && state.m_verticalVelocity < 0.0 && random.range(0, 99) >= 10;
+    }
+
+    // Cell by cell along the ray, crossing whichever cell edge comes next,
+    // asking the map about each cell. What castRay's run skipping must agree with.
+    double referenceRay(
+        const OccupancyMap& map,
+        const int width,
+        const int row,
+        const int col,
+        const OccupancyMap::Ray& ray)
+    {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        const double maxDistance = ray.m_maxDistance;
+        const double dx = ray.m_direction.m_col;
+        const double dy = ray.m_direction.m_row;
+        const int stepCol = (dx > 0.0) ? 1 : -1;
+        const int stepRow = (dy > 0.0) ? 1 : -1;
+        const double tPerCol = (dx != 0.0) ? 1.0 / std::abs(dx) : infinity;
+        const double tPerRow = (dy != 0.0) ? 1.0 / std::abs(dy) : infinity;
+        double tNextCol = 0.5 * tPerCol;
+        double tNextRow = 0.5 * tPerRow;
+        double t = 0.0;
+        int currentRow = row;
+        int currentCol = col;
+
+        for (;;)
+        {
+            if (map.occupied(currentRow, currentCol))
+            {
+                return std::min(t, maxDistance);
+            }
+
+            if (tNextCol < tNextRow)
+            {
+                t = tNextCol;
+                tNextCol += tPerCol;
+                currentCol += stepCol;
+            }
+            else
+            {
+                t = tNextRow;
+                tNextRow += tPerRow;
+                currentRow += stepRow;
+            }
+
+            if (t >= maxDistance || currentCol < 0 || currentCol >= width)
+            {
+                return maxDistance;
+            }
+        }
+    }
+
+    // Plays frames of flapping toward each gap, restarting whenever the
+    // bird dies, and counts those the scrolling field draws differently
+    // from Scene::compose on a cleared buffer
+    int scrollingMismatches(const GameParameters& parameters, const int frames, const uint64_t seed)
+    {
+        const size_t cells = static_cast<size_t>(parameters.m_width) * parameters.m_height;
+        std::vector<CHAR_INFO> expected(cells);
+        std::vector<CHAR_INFO> scrolled(cells);
+        ScrollingField field(parameters.m_width, parameters.m_height);
+
+        Random random;
+        random.seed(seed);
+
+        GameState state;
+        state.m_random.seed(seed);
+        Simulation::reset(state, parameters);
+        int mismatches = 0;
+
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            const Pipe* pipe = Simulation::nextPipe(state);
+            const double middle = (pipe != nullptr) ? pipe->m_gapStartRow + (pipe->m_gapSize * 0.5) : parameters.m_height * 0.5;
+            const bool jump = state.m_rowDouble > middle && state.m_verticalVelocity < 0.0 && random.range(0, 9) != 0;
+            Simulation::step(state, parameters, jump, 1.0 / 60.0);
+
+            if (!state.m_running)
+            {
+                Simulation::reset(state, parameters);
+            }
+
+            for (CHAR_INFO& cell : expected)
+            {
+                cell.Attributes = 0;
+                cell.Char.UnicodeChar = L' ';
+            }
+
+            Scene::compose(state, parameters, 60.0, expected);
+            field.compose(state, parameters, 60.0, scrolled);
+
+            const bool same = std::equal(expected.begin(), expected.end(), scrolled.begin(),
+                [](const CHAR_INFO& lhs, const CHAR_INFO& rhs)
+                {
+                    return lhs.Attributes == rhs.Attributes && lhs.Char.UnicodeChar == rhs.Char.UnicodeChar;
+                });
+
+            mismatches += same ? 0 : 1;
+        }
+
+        return mismatches;
+    }
+
+    bool sameGame(const GameState& lhs, const GameState& rhs)
+    {
+        return lhs.m_score == rhs.m_score
+            && lhs.m_rowDouble == rhs.m_rowDouble
+            && lhs.m_verticalVelocity == rhs.m_verticalVelocity
+            && lhs.m_running == rhs.m_running
+            && lhs.m_random.m_state == rhs.m_random.m_state
+            && lhs.m_pipes[0].m_colPosition == rhs.m_pipes[0].m_colPosition;
+    }
+}
+
+
+// Search Nodes Per Second
+// Lets the bot play a headless game and reports how fast it searches.
+//
+int Benchmarks::searchNodesPerSecond(void)
+{
+    using namespace std::chrono;
+
+    GameParameters parameters;
+    GameState state;
+    Simulation::reset(state, parameters);
+
+    // Raw snapshot cost
+    constexpr int snapshotIterations = 10'000'000;
+    GameState copy = state;
+    auto start = high_resolution_clock::now();
+
+    for (int i = 0; i < snapshotIterations; ++i)
+    {
+        copy = state;
+        copy.m_score += i;
+        state.m_score ^= copy.m_score & 1;
+    }
+
+    const double snapshotSeconds = duration<double>(high_resolution_clock::now() - start).count();
+    std::cout << "Snapshot size:     " << sizeof(GameState) << " bytes" << std::endl;
+    std::cout << "Snapshots/second:  " << (snapshotIterations / snapshotSeconds) << std::endl;
+
+    // Beam search
+    Simulation::reset(state, parameters);
+    Autopilot autopilot(32, 12, 4, 1.0 / 60.0);
+
+    constexpr int ticks = 60 * 60;
+    int survived = 0;
+    start = high_resolution_clock::now();
+
+    for (; survived < ticks && state.m_running; ++survived)
+    {
+        const bool jump = autopilot.decide(state, parameters);
+        Simulation::step(state, parameters, jump, autopilot.tickSeconds());
+    }
+
+    const double searchSeconds = duration<double>(high_resolution_clock::now() - start).count();
+    std::cout << "Ticks survived:    " << survived << " / " << ticks << std::endl;
+    std::cout << "Score:             " << state.m_score << std::endl;
+    std::cout << "Nodes expanded:    " << autopilot.nodesExpanded() << std::endl;
+    std::cout << "Nodes/second:      " << (autopilot.nodesExpanded() / searchSeconds) << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+
+// Render Frames Per Second
+// Composes the same recorded states at 120x30 with each renderer, after
+// checking the scrolling field against the cell path frame by frame.
+//
+int Benchmarks::renderFramesPerSecond(void)
+{
+    using namespace std::chrono;
+
+    GameParameters parameters;
+    GameState state;
+    Simulation::reset(state, parameters);
+
+    // A second of play, flapping every 20 ticks
+    std::vector<GameState> states;
+
+    for (int tick = 0; tick < 60; ++tick)
+    {
+        Simulation::step(state, parameters, tick % 20 == 0, 1.0 / 60.0);
+        states.push_back(state);
+    }
+
+    std::vector<CHAR_INFO> buffer(static_cast<size_t>(parameters.m_width) * parameters.m_height);
+    constexpr int frames = 20'000;
+    constexpr int rounds = 5;
+
+    // The scrolling field must match the cell path exactly, also on a level
+    // whose pipes touch or share their lip columns
+    std::vector<LevelPipe> tightLevel(1000);
+    Random levelRandom;
+    levelRandom.seed(11);
+
+    for (LevelPipe& pipe : tightLevel)
+    {
+        pipe.m_gapStartRow = static_cast<uint8_t>(levelRandom.range(2, 18));
+        pipe.m_gapSize = static_cast<uint8_t>(levelRandom.range(5, 10));
+        pipe.m_spacing = static_cast<uint16_t>(levelRandom.range(0, 3));
+    }
+
+    GameParameters tightParameters = parameters;
+    tightParameters.m_levelPipes = tightLevel.data();
+    tightParameters.m_levelPipeCount = tightLevel.size();
+
+    const int courseMismatches = scrollingMismatches(parameters, frames, 5);
+    const int levelMismatches = scrollingMismatches(tightParameters, frames, 5);
+    std::cout << "Scrolling vs cells: " << courseMismatches << " of " << frames << " frames differ, "
+              << levelMismatches << " of " << frames << " on a tightly spaced level" << std::endl;
+
+    if (courseMismatches != 0 || levelMismatches != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // As in the game, the cell path needs the engine's clear first and the
+    // canvas paths, which write every cell, do not. Best of a few rounds.
+    auto report = [&](const char* name, auto&& composeFrame)
+    {
+        double best = 0.0;
+
+        for (int round = 0; round < rounds; ++round)
+        {
+            const auto start = high_resolution_clock::now();
+
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                composeFrame(states[frame % states.size()]);
+            }
+
+            const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+            best = (round == 0) ? seconds : std::min(best, seconds);
+        }
+
+        std::cout << name << " " << (best / frames) * 1e9 << " ns/frame" << std::endl;
+    };
+
+    report("Cells:              ", [&](const GameState& frameState)
+    {
+        for (CHAR_INFO& cell : buffer)
+        {
+            cell.Attributes = 0;
+            cell.Char.UnicodeChar = L' ';
+        }
+
+        Scene::compose(frameState, parameters, 60.0, buffer);
+    });
+
+    ScrollingField field(parameters.m_width, parameters.m_height);
+
+    report("Cells (scrolling):  ", [&](const GameState& frameState)
+    {
+        field.compose(frameState, parameters, 60.0, buffer);
+    });
+
+    std::cout << "  Columns rasterized: " << static_cast<double>(field.rasterizedColumns()) / (frames * rounds)
+              << " per frame" << std::endl;
+
+    for (const auto mode : { PixelCanvas::Mode::HALF_BLOCK, PixelCanvas::Mode::BRAILLE })
+    {
+        PixelCanvas canvas(mode, parameters.m_width, parameters.m_height);
+        const bool braille = (mode == PixelCanvas::Mode::BRAILLE);
+
+        canvas.forceScalar(true);
+        report(braille ? "Braille (scalar):   " : "Half block (scalar):", [&](const GameState& frameState)
+        {
+            Scene::composeHighResolution(frameState, parameters, 60.0, canvas, buffer);
+        });
+
+        if (!Cpu::hasAVX2())
+        {
+            continue;
+        }
+
+        canvas.forceScalar(false);
+        report(braille ? "Braille (AVX2):     " : "Half block (AVX2):  ", [&](const GameState& frameState)
+        {
+            Scene::composeHighResolution(frameState, parameters, 60.0, canvas, buffer);
+        });
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+// Compositor Scaling
+// Plays the same few seconds at each size, from a fresh compositor for
+// every thread count, so each run sends exactly the same frames. The bytes
+// are hashed to show the merge does not depend on the thread count.
+//
+int Benchmarks::compositorScaling(void)
+{
+    using namespace std::chrono;
+
+    const int sizes[][2] = { { 120, 30 }, { 250, 75 }, { 400, 120 }, { 1000, 300 } };
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+    bool deterministic = true;
+
+    std::cout << "     size  bands";
+
+    for (const int threads : threadCounts)
+    {
+        std::cout << std::setw(9) << threads << "T";
+    }
+
+    std::cout << "   (us/frame)" << std::endl;
+
+    for (const auto& size : sizes)
+    {
+        GameParameters parameters;
+        parameters.m_width = size[0];
+        parameters.m_height = size[1];
+
+        GameState state;
+        Simulation::reset(state, parameters);
+        std::vector<GameState> states;
+
+        for (int tick = 0; tick < 240; ++tick)
+        {
+            Simulation::step(state, parameters, tick % 20 == 0, 1.0 / 60.0);
+            states.push_back(state);
+        }
+
+        // Roughly the same amount of work at every size
+        const int cells = size[0] * size[1];
+        const int frames = std::max(static_cast<int>(states.size()), 20'000'000 / cells);
+
+        std::cout << std::setw(5) << size[0] << "x" << std::left << std::setw(4) << size[1] << std::right;
+
+        uint64_t firstHash = 0;
+
+        for (size_t t = 0; t < std::size(threadCounts); ++t)
+        {
+            BandedCompositor compositor(size[0], size[1], threadCounts[t]);
+
+            if (t == 0)
+            {
+                std::cout << std::setw(6) << compositor.bandCount();
+            }
+
+            uint64_t hash = 0xCBF29CE484222325ull;
+            double seconds = 0.0;
+
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                const auto start = high_resolution_clock::now();
+                const std::string& bytes = compositor.compose(states[frame % states.size()], parameters, 60.0);
+                seconds += duration<double>(high_resolution_clock::now() - start).count();
+
+                // FNV-1a, outside the timing
+                for (const char byte : bytes)
+                {
+                    hash = (hash ^ static_cast<unsigned char>(byte)) * 0x100000001B3ull;
+                }
+            }
+
+            std::cout << std::setw(10) << std::fixed << std::setprecision(1) << (seconds / frames) * 1e6;
+
+            if (t == 0)
+            {
+                firstHash = hash;
+            }
+            else if (hash != firstHash)
+            {
+                deterministic = false;
+            }
+        }
+
+        std::cout << std::endl;
+    }
+
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "Output identical across thread counts: " << (deterministic ? "yes" : "NO") << std::endl;
+
+    return deterministic ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Episode Throughput
+// Short headless games as a training run plays them: each episode builds
+// its own bot and replay, plays until the bird dies or time runs out, and
+// throws them away. Run with everything on the heap, then with the same
+// containers in one arena per thread that is reset between episodes.
+//
+int Benchmarks::episodeThroughput(void)
+{
+    using namespace std::chrono;
+
+    constexpr double tickSeconds = 1.0 / 60.0;
+    constexpr int episodes = 2000;
+    constexpr int resetEpisodes = 200'000;
+    constexpr int maxTicks = 300;
+    constexpr size_t arenaBytes = 2 * 1024 * 1024; // A replay reserves about 1 MB
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+
+    GameParameters parameters;
+
+    // Returns the score, so the two runs can be checked against each other.
+    // With no ticks it is just the episode's set-up and tear-down.
+    auto playEpisode = [&](const int episode, const int ticks, std::pmr::memory_resource* resource) -> size_t
+    {
+        Autopilot bot(4, 4, 2, tickSeconds, resource);
+        Replay replay(resource);
+        GameState state;
+        state.m_random.seed(static_cast<uint64_t>(episode) + 1);
+        Simulation::reset(state, parameters);
+        replay.begin(state, parameters);
+
+        for (int tick = 0; tick < ticks && state.m_running; ++tick)
+        {
+            const bool jump = bot.decide(state, parameters);
+            replay.record(tickSeconds, jump);
+            Simulation::step(state, parameters, jump, tickSeconds);
+        }
+
+        return state.m_score;
+    };
+
+    // Episodes per second and the total score
+    auto run = [&](const int threadCount, const int episodes, const int ticks, const bool useArena) -> std::pair<double, size_t>
+    {
+        std::atomic<int> next = 0;
+        std::atomic<size_t> totalScore = 0;
+        std::vector<std::unique_ptr<EpisodeArena>> arenas;
+
+        // Built before the clock starts, as a training run would once
+        for (int i = 0; useArena && i < threadCount; ++i)
+        {
+            arenas.push_back(std::make_unique<EpisodeArena>(arenaBytes));
+        }
+
+        const auto start = high_resolution_clock::now();
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            workers.emplace_back([&, t](void)
+            {
+                size_t score = 0;
+
+                for (int episode = next++; episode < episodes; episode = next++)
+                {
+                    if (useArena)
+                    {
+                        arenas[t]->reset();
+                        score += playEpisode(episode, ticks, arenas[t]->resource());
+                    }
+                    else
+                    {
+                        score += playEpisode(episode, ticks, std::pmr::get_default_resource());
+                    }
+                }
+
+                totalScore += score;
+            });
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+
+        return { episodes / seconds, totalScore.load() };
+    };
+
+    std::cout << "Episodes of up to " << maxTicks << " ticks, " << episodes << " per run" << std::endl;
+    std::cout << "Threads     Heap (episodes/s)    Arena (episodes/s)    Reset, heap (ns)    Reset, arena (ns)" << std::endl;
+
+    bool sameResults = true;
+
+    for (const int threads : threadCounts)
+    {
+        const auto heap = run(threads, episodes, maxTicks, false);
+        const auto arena = run(threads, episodes, maxTicks, true);
+        sameResults = sameResults && heap.second == arena.second;
+
+        // Set-up and tear-down alone, which is all the allocation there is
+        const double heapReset = 1e9 / run(threads, resetEpisodes, 0, false).first;
+        const double arenaReset = 1e9 / run(threads, resetEpisodes, 0, true).first;
+
+        std::cout << std::setw(7) << threads
+                  << std::setw(22) << std::fixed << std::setprecision(0) << heap.first
+                  << std::setw(22) << arena.first
+                  << std::setw(20) << heapReset
+                  << std::setw(21) << arenaReset << std::endl;
+    }
+
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "Same scores either way: " << (sameResults ? "yes" : "NO") << std::endl;
+
+    return sameResults ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Rewind History
+// Plays longer than the history holds, so the oldest intervals have been
+// dropped, then rewinds as far as it goes and checks every state against
+// a copy kept of each tick. Then plays on differently from there and
+// rewinds again, which must give the new states, not the old ones.
+//
+int Benchmarks::rewindHistory(void)
+{
+    using namespace std::chrono;
+
+    constexpr double tickSeconds = 1.0 / 120.0;
+    constexpr double seconds = 60.0;
+    constexpr uint32_t playedTicks = 120 * 70;
+    constexpr uint32_t branchTicks = 120 * 5;
+
+    GameParameters parameters;
+    GameState state;
+    state.m_random.seed(2024);
+    Simulation::reset(state, parameters);
+
+    RewindHistory history(tickSeconds, seconds);
+    Random bot;
+    bot.seed(7);
+    std::vector<GameState> played;
+    played.reserve(playedTicks);
+
+    auto play = [&](const uint32_t ticks, const bool useBot)
+    {
+        for (uint32_t tick = 0; tick < ticks; ++tick)
+        {
+            const bool jump = useBot && versusBotJump(state, bot, 0);
+            played.push_back(state);
+            history.record(state, jump);
+            Simulation::step(state, parameters, jump, tickSeconds);
+        }
+    };
+
+    // Rewinds to the oldest tick, checking each state; returns the steps taken
+    auto rewind = [&](bool& matched, double& worstStepSeconds) -> size_t
+    {
+        size_t steps = 0;
+
+        for (;;)
+        {
+            const auto start = high_resolution_clock::now();
+            const bool stepped = history.stepBack(state, parameters);
+            worstStepSeconds = std::max(worstStepSeconds, duration<double>(high_resolution_clock::now() - start).count());
+
+            if (!stepped)
+            {
+                return steps;
+            }
+
+            ++steps;
+            const GameState& expected = played[played.size() - steps];
+            matched = matched && sameGame(state, expected) && state.m_row == expected.m_row;
+        }
+    };
+
+    play(playedTicks, true);
+
+    const double secondsHeld = history.secondsAvailable();
+    bool matched = true;
+    double worstStepSeconds = 0.0;
+    const auto start = high_resolution_clock::now();
+    const size_t steps = rewind(matched, worstStepSeconds);
+    const double rewindSeconds = duration<double>(high_resolution_clock::now() - start).count();
+
+    // Branch: the ticks stepped back over are gone
+    played.resize(played.size() - steps);
+    play(branchTicks, false);
+    double branchWorst = 0.0;
+    const size_t branchSteps = rewind(matched, branchWorst);
+    const bool complete = (steps >= seconds / tickSeconds) && (branchSteps == branchTicks);
+
+    const size_t everyState = static_cast<size_t>(seconds / tickSeconds) * sizeof(GameState);
+
+    std::cout << "Ticks played:       " << playedTicks << " at " << (1.0 / tickSeconds) << " Hz" << std::endl;
+    std::cout << "History held:       " << secondsHeld << " s (" << steps << " ticks)" << std::endl;
+    std::cout << "Memory:             " << history.memoryBytes() << " bytes, against "
+              << everyState << " for every state of " << seconds << " s" << std::endl;
+    std::cout << "Step back:          " << (rewindSeconds / steps * 1e9) << " ns average, "
+              << (worstStepSeconds * 1e6) << " us worst (an interval rebuilt)" << std::endl;
+    std::cout << "Rewound states match: " << (matched && complete ? "yes" : "NO") << std::endl;
+
+    return matched && complete ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Grid Frame Time
+// Ten seconds of an 8x8 grid at 60 frames per second, with each frame's
+// simulation and tiling timed. The last frame is hashed to show the tiles
+// do not depend on the thread count.
+//
+int Benchmarks::gridFrameTime(void)
+{
+    using namespace std::chrono;
+
+    constexpr int columns = 8;
+    constexpr int rows = 8;
+    constexpr int frameWidth = 240;
+    constexpr int frameHeight = 65;
+    constexpr int frames = 600;
+    constexpr double frameSeconds = 1.0 / 60.0;
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+
+    GameParameters parameters;
+    bool deterministic = true;
+    uint64_t firstHash = 0;
+
+    std::cout << columns * rows << " games on a " << frameWidth << "x" << frameHeight << " frame, "
+              << frames << " frames" << std::endl;
+    std::cout << "Threads   Mean (ms)   Worst (ms)   Finished   Best" << std::endl;
+
+    for (size_t t = 0; t < std::size(threadCounts); ++t)
+    {
+        GameGrid grid(parameters, columns, rows, frameWidth, frameHeight, 1, threadCounts[t]);
+        std::vector<CHAR_INFO> frame(static_cast<size_t>(frameWidth) * frameHeight);
+        double total = 0.0;
+        double worst = 0.0;
+
+        for (int i = 0; i < frames; ++i)
+        {
+            const auto start = high_resolution_clock::now();
+            grid.update(frameSeconds, frame);
+            const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+
+            total += seconds;
+            worst = std::max(worst, seconds);
+        }
+
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        for (const CHAR_INFO& cell : frame)
+        {
+            hash = (hash ^ static_cast<uint64_t>(cell.Char.UnicodeChar)) * 0x100000001B3ull;
+            hash = (hash ^ static_cast<uint64_t>(cell.Attributes)) * 0x100000001B3ull;
+        }
+
+        if (t == 0)
+        {
+            firstHash = hash;
+        }
+        else if (hash != firstHash)
+        {
+            deterministic = false;
+        }
+
+        std::cout << std::setw(7) << threadCounts[t]
+                  << std::setw(12) << std::fixed << std::setprecision(2) << (total / frames) * 1e3
+                  << std::setw(13) << worst * 1e3
+                  << std::setw(11) << grid.gamesPlayed()
+                  << std::setw(7) << grid.bestScore() << std::endl;
+    }
+
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "Frame budget at 60 FPS: " << frameSeconds * 1e3 << " ms" << std::endl;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "Tiles identical across thread counts: " << (deterministic ? "yes" : "NO") << std::endl;
+
+    return deterministic ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Sensor Rays
+// Over the states of a bot game: every cell of each map against
+// Pipe::isHit, and every ray against a cell by cell walk, then the cost
+// of building the map and casting a fan.
+//
+int Benchmarks::sensorRays(void)
+{
+    using namespace std::chrono;
+
+    constexpr int rayCount = 32;
+    constexpr double maxDistance = 60.0;
+    constexpr int ticks = 60 * 60;
+    constexpr int timedRounds = 200;
+
+    GameParameters parameters;
+    GameState state;
+    state.m_random.seed(2024);
+    Simulation::reset(state, parameters);
+
+    Random bot;
+    bot.seed(5);
+    std::vector<GameState> states;
+
+    for (int tick = 0; tick < ticks && state.m_running; ++tick)
+    {
+        Simulation::step(state, parameters, versusBotJump(state, bot, 0), 1.0 / 60.0);
+        states.push_back(state);
+    }
+
+    OccupancyMap map(parameters.m_width, parameters.m_height);
+    const std::vector<OccupancyMap::Ray> rays = OccupancyMap::fan(rayCount, maxDistance);
+
+    // Some random directions too, left and right, not just the fan
+    std::vector<OccupancyMap::Ray> anyRays = rays;
+    Random angles;
+    angles.seed(9);
+
+    for (int i = 0; i < 64; ++i)
+    {
+        const double angle = angles.range(0, 359'999) * 1e-3 * (3.14159265358979 / 180.0);
+        anyRays.push_back(OccupancyMap::prepareRay({ std::cos(angle), std::sin(angle) }, maxDistance));
+    }
+
+    uint64_t cellMismatches = 0;
+    uint64_t rayMismatches = 0;
+    uint64_t raysChecked = 0;
+
+    for (const GameState& frame : states)
+    {
+        map.build(frame);
+
+        for (int row = 0; row < parameters.m_height; ++row)
+        {
+            for (int col = 0; col < parameters.m_width; ++col)
+            {
+                bool hit = false;
+
+                for (const Pipe& pipe : frame.m_pipes)
+                {
+                    hit = hit || pipe.isHit(row, col, parameters.m_width, parameters.m_height);
+                }
+
+                cellMismatches += (hit != map.occupied(row, col)) ? 1 : 0;
+            }
+        }
+
+        for (const OccupancyMap::Ray& ray : anyRays)
+        {
+            const double fast = map.castRay(frame.m_row, frame.m_col, ray);
+            const double slow = referenceRay(map, parameters.m_width, frame.m_row, frame.m_col, ray);
+            rayMismatches += (std::abs(fast - slow) > 1e-9) ? 1 : 0;
+            ++raysChecked;
+        }
+    }
+
+    // Timing: rebuilding from each state in turn, then casting a fan from
+    // each with its map, kept apart so neither timing holds clock reads
+    std::vector<double> distances(rayCount);
+    double sink = 0.0;
+
+    auto start = high_resolution_clock::now();
+
+    for (int round = 0; round < timedRounds; ++round)
+    {
+        for (const GameState& frame : states)
+        {
+            map.build(frame);
+            sink += map.occupied(frame.m_row, frame.m_col + Pipe::m_width) ? 1.0 : 0.0;
+        }
+    }
+
+    const double buildSeconds = duration<double>(high_resolution_clock::now() - start).count();
+    double castSeconds = 0.0;
+
+    for (const GameState& frame : states)
+    {
+        map.build(frame);
+        start = high_resolution_clock::now();
+
+        for (int round = 0; round < timedRounds; ++round)
+        {
+            map.castRays(frame.m_row, frame.m_col, rays, distances.data());
+            sink += distances[round % rayCount];
+        }
+
+        castSeconds += duration<double>(high_resolution_clock::now() - start).count();
+    }
+
+    const double builds = static_cast<double>(timedRounds) * states.size();
+
+    std::cout << "States:             " << states.size() << " (" << parameters.m_width << "x" << parameters.m_height << ")" << std::endl;
+    std::cout << "Build map:          " << (buildSeconds / builds) * 1e9 << " ns" << std::endl;
+    std::cout << "Cast " << rayCount << " rays:       " << (castSeconds / builds) * 1e9 << " ns ("
+              << (castSeconds / (builds * rayCount)) * 1e9 << " ns/ray)" << std::endl;
+    std::cout << "Cells vs isHit:     " << cellMismatches << " mismatches" << std::endl;
+    std::cout << "Rays vs cell walk:  " << rayMismatches << " of " << raysChecked << " differ" << std::endl;
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return (cellMismatches == 0 && rayMismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Level Streaming
+// Each pass starts from a fresh mapping, so the working set shows what
+// playing through costs with pages given back and with them kept. Steps
+// are long so that a pass is quick; only the course is being tested.
+//
+int Benchmarks::levelStreaming(void)
+{
+    using namespace std::chrono;
+
+    constexpr uint64_t pipeCount = 4'000'000;
+    constexpr int opens = 100;
+    constexpr double stepSeconds = 0.5;
+    const std::string path = "level-stream.dat";
+
+    auto workingSetBytes = [](void)
+    {
+        PROCESS_MEMORY_COUNTERS counters = {};
+        counters.cb = sizeof(counters);
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+        return static_cast<double>(counters.WorkingSetSize);
+    };
+
+    auto start = high_resolution_clock::now();
+
+    if (!Level::write(path, pipeCount, 7, GameParameters().m_height))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const double writeSeconds = duration<double>(high_resolution_clock::now() - start).count();
+    uint64_t mismatches = 0;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Level:              " << pipeCount << " pipes, "
+              << (pipeCount * sizeof(LevelPipe)) / (1024.0 * 1024.0) << " MB" << std::endl;
+    std::cout << "Write:              " << writeSeconds * 1e3 << " ms" << std::endl;
+
+    {
+        Level level;
+        start = high_resolution_clock::now();
+
+        for (int i = 0; i < opens; ++i)
+        {
+            if (!level.open(path))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+
+        const double openSeconds = duration<double>(high_resolution_clock::now() - start).count() / opens;
+        std::cout << "Open:               " << openSeconds * 1e6 << " us" << std::endl;
+
+        for (const bool release : { true, false })
+        {
+            if (!level.open(path))
+            {
+                return EXIT_FAILURE;
+            }
+
+            GameParameters parameters;
+            level.apply(parameters);
+
+            GameState state;
+            Simulation::reset(state, parameters);
+
+            const double baseline = workingSetBytes();
+            double peak = baseline;
+            uint64_t laidOut = GameState::m_pipeCount;
+            uint64_t cursor = state.m_levelCursor;
+            uint64_t steps = 0;
+
+            start = high_resolution_clock::now();
+
+            while (laidOut < pipeCount)
+            {
+                Simulation::step(state, parameters, false, stepSeconds);
+
+                // Whatever came on is at the back, in the file's order, each
+                // its spacing clear of the pipe before
+                const uint64_t added = (state.m_levelCursor + pipeCount - cursor) % pipeCount;
+
+                for (uint64_t i = 0; i < added; ++i)
+                {
+                    const int index = GameState::m_pipeCount - static_cast<int>(added - i);
+                    const Pipe& pipe = state.m_pipes[index];
+                    const LevelPipe& expected = level.pipes()[(cursor + i) % pipeCount];
+                    const int spacing = pipe.m_col - state.m_pipes[index - 1].m_col - Pipe::m_width;
+
+                    mismatches += (pipe.m_gapStartRow != expected.m_gapStartRow
+                                || pipe.m_gapSize != expected.m_gapSize
+                                || spacing != expected.m_spacing) ? 1 : 0;
+                }
+
+                cursor = state.m_levelCursor;
+                laidOut += added;
+
+                if (release)
+                {
+                    level.release(cursor);
+                }
+
+                if ((++steps % 65'536) == 0)
+                {
+                    peak = std::max(peak, workingSetBytes());
+                }
+            }
+
+            const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+            peak = std::max(peak, workingSetBytes());
+
+            std::cout << (release ? "Stream, released:   " : "Stream, kept:       ")
+                      << (seconds / laidOut) * 1e9 << " ns/pipe, working set +"
+                      << (peak - baseline) / (1024.0 * 1024.0) << " MB" << std::endl;
+        }
+    }
+
+    DeleteFileA(path.c_str());
+
+    std::cout << "Pipes vs file:      " << mismatches << " mismatches" << std::endl;
+
+    return (mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Versus Loopback
+// Runs both sides in this process, one tick of virtual time per loop, so
+// the lag is exact and the run takes only as long as the simulation. Both
+// must end on the state a straight replay of the jumps gives.
+//
+int Benchmarks::versusLoopback(void)
+{
+    using namespace std::chrono;
+
+    constexpr double tickSeconds = 1.0 / 60.0;
+    constexpr uint32_t maxTicks = 60 * 120;
+    constexpr uint16_t firstPort = 47'000;
+    const LinkConditions conditionsToTry[] = { { 0, 0 }, { 50, 5 }, { 100, 10 }, { 200, 20 } };
+
+    GameParameters parameters;
+    Random course;
+    course.seed(2024);
+    bool allPassed = true;
+
+    for (size_t c = 0; c < std::size(conditionsToTry); ++c)
+    {
+        const LinkConditions& conditions = conditionsToTry[c];
+        const uint16_t port = static_cast<uint16_t>(firstPort + (2 * c));
+
+        UdpLink links[2];
+
+        if (!links[0].open(port, port + 1, conditions, 2 * c) || !links[1].open(port + 1, port, conditions, (2 * c) + 1))
+        {
+            return EXIT_FAILURE;
+        }
+
+        RollbackSession host(parameters, course, 0, tickSeconds);
+        RollbackSession guest(parameters, course, 1, tickSeconds);
+        RollbackSession* sessions[2] = { &host, &guest };
+        Random bots[2];
+        bots[0].seed(100 + c);
+        bots[1].seed(200 + c);
+        std::vector<uint32_t> jumps[2];
+
+        double rollbackSeconds = 0.0;
+        double worstRollbackSeconds = 0.0;
+        uint32_t ticks = 0;
+
+        auto done = [&](void) -> bool
+        {
+            return host.finished() && guest.finished() && host.peerCaughtUp() && guest.peerCaughtUp();
+        };
+
+        for (; ticks < maxTicks && !done(); ++ticks)
+        {
+            const double now = ticks * tickSeconds;
+
+            for (int side = 0; side < 2; ++side)
+            {
+                RollbackSession& session = *sessions[side];
+                InputPacket incoming;
+
+                for (;;)
+                {
+                    const size_t size = links[side].receive(&incoming, sizeof(incoming));
+
+                    if (size == 0)
+                    {
+                        break;
+                    }
+
+                    const uint64_t rollbacksBefore = session.statistics().m_rollbacks;
+                    const auto start = high_resolution_clock::now();
+                    session.receive(incoming);
+                    const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+
+                    if (session.statistics().m_rollbacks != rollbacksBefore)
+                    {
+                        rollbackSeconds += seconds;
+                        worstRollbackSeconds = std::max(worstRollbackSeconds, seconds);
+                    }
+                }
+
+                if (!session.finished() && session.canAdvance())
+                {
+                    const bool jump = versusBotJump(session.local(), bots[side], session.tick());
+
+                    if (jump)
+                    {
+                        jumps[side].push_back(session.tick());
+                    }
+
+                    session.advance(jump);
+                }
+
+                const InputPacket outgoing = session.makePacket();
+                links[side].send(&outgoing, outgoing.size(), now);
+                links[side].flush(now);
+            }
+        }
+
+        // What both sides should have ended on
+        VersusState expected;
+
+        for (GameState& player : expected.m_players)
+        {
+            player.m_random = course;
+            Simulation::reset(player, parameters);
+        }
+
+        for (uint32_t tick = 0; tick < maxTicks; ++tick)
+        {
+            for (int player = 0; player < 2; ++player)
+            {
+                GameState& game = expected.m_players[player];
+                const bool jump = std::binary_search(jumps[player].begin(), jumps[player].end(), tick);
+
+                if (game.m_running)
+                {
+                    Simulation::step(game, parameters, jump, tickSeconds);
+                }
+            }
+        }
+
+        bool agree = done();
+
+        for (const RollbackSession* session : sessions)
+        {
+            for (int player = 0; player < 2; ++player)
+            {
+                agree = agree && sameGame(session->state().m_players[player], expected.m_players[player]);
+            }
+        }
+
+        allPassed = allPassed && agree;
+
+        uint64_t rollbacks = 0;
+        uint64_t resimulatedTicks = 0;
+        uint32_t deepest = 0;
+
+        for (const RollbackSession* session : sessions)
+        {
+            rollbacks += session->statistics().m_rollbacks;
+            resimulatedTicks += session->statistics().m_resimulatedTicks;
+            deepest = std::max(deepest, session->statistics().m_deepestRollback);
+        }
+
+        std::cout << "Lag " << conditions.m_delayMilliseconds << " ms, loss " << conditions.m_lossPercent << "%:" << std::endl;
+        std::cout << "  Ticks:              " << ticks << " (scores " << expected.m_players[0].m_score
+                  << " vs " << expected.m_players[1].m_score << ")" << std::endl;
+        std::cout << "  Rollbacks:          " << rollbacks << ", deepest " << deepest << " ticks" << std::endl;
+
+        if (resimulatedTicks > 0)
+        {
+            const double perTick = rollbackSeconds / resimulatedTicks;
+            std::cout << "  Re-simulation:      " << (perTick * 1e9) << " ns/tick, "
+                      << static_cast<uint64_t>(tickSeconds / perTick) << " ticks fit in one frame" << std::endl;
+            std::cout << "  Worst rollback:     " << (worstRollbackSeconds * 1e6) << " us" << std::endl;
+        }
+
+        std::cout << "  Both sides agree:   " << (agree ? "yes" : "NO") << std::endl;
+    }
+
+    return allPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Leaderboard Stress
+// Spawns writer processes against a fresh file and keeps taking snapshots
+// while they run. Slots only grow, so each sorted snapshot must be at least
+// the previous one, entry by entry.
+//
+int Benchmarks::leaderboardStress(const int writerCount)
+{
+    using namespace std::chrono;
+
+    const std::string path = "leaderboard-stress.dat";
+    const int writers = std::clamp(writerCount, 1, static_cast<int>(MAXIMUM_WAIT_OBJECTS));
+
+    DeleteFileA(path.c_str());
+
+    Leaderboard leaderboard;
+
+    if (!leaderboard.open(path))
+    {
+        return EXIT_FAILURE;
+    }
+
+    char executable[MAX_PATH];
+    GetModuleFileNameA(nullptr, executable, MAX_PATH);
+
+    std::vector<HANDLE> processes;
+    const auto start = high_resolution_clock::now();
+
+    for (int i = 0; i < writers; ++i)
+    {
+        std::string commandLine = "\"" + std::string(executable) + "\" --leaderboard-writer \""
+                                + path + "\" " + std::to_string(i);
+
+        STARTUPINFOA startupInfo = {};
+        startupInfo.cb = sizeof(startupInfo);
+        PROCESS_INFORMATION processInfo = {};
+
+        if (!CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo))
+        {
+            std::cout << "Unable to start writer process " << i << std::endl;
+            break;
+        }
+
+        CloseHandle(processInfo.hThread);
+        processes.push_back(processInfo.hProcess);
+    }
+
+    // Watch the board while the writers run
+    std::vector<LeaderboardEntry> previous;
+    uint64_t snapshots = 0;
+    bool consistent = true;
+
+    for (;;)
+    {
+        const DWORD waitResult = WaitForMultipleObjects(
+            static_cast<DWORD>(processes.size()), processes.data(), TRUE, 0);
+
+        const std::vector<LeaderboardEntry> current = leaderboard.snapshot();
+        ++snapshots;
+
+        if (current.size() < previous.size())
+        {
+            consistent = false;
+        }
+
+        for (size_t i = 0; i < std::min(current.size(), previous.size()); ++i)
+        {
+            if (current[i].m_score < previous[i].m_score)
+            {
+                consistent = false;
+            }
+        }
+
+        previous = current;
+
+        if (waitResult != WAIT_TIMEOUT)
+        {
+            break;
+        }
+    }
+
+    const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+    bool writersSucceeded = static_cast<int>(processes.size()) == writers;
+
+    for (const HANDLE process : processes)
+    {
+        DWORD exitCode = EXIT_FAILURE;
+        GetExitCodeProcess(process, &exitCode);
+        writersSucceeded = writersSucceeded && (exitCode == EXIT_SUCCESS);
+        CloseHandle(process);
+    }
+
+    // Expected board: the best m_capacity of everything submitted
+    std::vector<uint32_t> expected;
+
+    for (int i = 0; i < writers; ++i)
+    {
+        Random random;
+        random.seed(i);
+
+        for (int j = 0; j < STRESS_SUBMISSIONS_PER_WRITER; ++j)
+        {
+            expected.push_back(stressScore(random));
+        }
+    }
+
+    std::sort(expected.begin(), expected.end(), std::greater<uint32_t>());
+    expected.resize(std::min(expected.size(), static_cast<size_t>(Leaderboard::m_capacity)));
+
+    const std::vector<LeaderboardEntry> board = leaderboard.snapshot();
+    bool correct = board.size() == expected.size();
+
+    for (size_t i = 0; correct && i < board.size(); ++i)
+    {
+        correct = board[i].m_score == expected[i];
+    }
+
+    const double submissions = static_cast<double>(writers) * STRESS_SUBMISSIONS_PER_WRITER;
+    std::cout << "Writers:           " << writers << std::endl;
+    std::cout << "Submissions:       " << submissions << std::endl;
+    std::cout << "Submissions/second: " << (submissions / seconds) << std::endl;
+    std::cout << "Snapshots taken:   " << snapshots << std::endl;
+    std::cout << "Snapshots ordered: " << (consistent ? "yes" : "NO") << std::endl;
+    std::cout << "Writers succeeded: " << (writersSucceeded ? "yes" : "NO") << std::endl;
+    std::cout << "Final board:       " << (correct ? "matches" : "DOES NOT MATCH") << std::endl;
+
+    return (consistent && writersSucceeded && correct) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Leaderboard Writer
+//
+int Benchmarks::leaderboardWriter(const std::string& path, const int writerIndex)
+{
+    Leaderboard leaderboard;
+
+    if (!leaderboard.open(path))
+    {
+        return EXIT_FAILURE;
+    }
+
+    Random random;
+    random.seed(writerIndex);
+    const uint32_t processId = GetCurrentProcessId();
+
+    for (int i = 0; i < STRESS_SUBMISSIONS_PER_WRITER; ++i)
+    {
+        leaderboard.submit(stressScore(random), processId);
+    }
+
+    return EXIT_SUCCESS;
+}
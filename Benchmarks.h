@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+
+namespace Benchmarks
+{
+    // Snapshot save/restore throughput and beam-search nodes per second
+    //
+    [[nodiscard]] int searchNodesPerSecond(void);
+
+    // Per-cell scene, redrawn and scrolled, against the half block and
+    // Braille canvases, with the packing kernel both vectorized and scalar.
+    // Every scrolled frame is checked against the redrawn one first.
+    //
+    [[nodiscard]] int renderFramesPerSecond(void);
+
+    // Banded compose and encode per frame across screen sizes and thread
+    // counts, checking the bytes do not depend on the thread count
+    //
+    [[nodiscard]] int compositorScaling(void);
+
+    // An 8x8 grid of bot games simulated and tiled per frame on 1 to 16
+    // threads, against the 60 FPS frame budget
+    //
+    [[nodiscard]] int gridFrameTime(void);
+
+    // Occupancy map build and ray fan cost over a bot game, with the map
+    // checked against Pipe::isHit and the rays against a cell by cell walk
+    //
+    [[nodiscard]] int sensorRays(void);
+
+    // Short headless episodes on 1 to 16 threads, each with its own bot and
+    // replay, allocated from the heap and then from per-thread arenas
+    //
+    [[nodiscard]] int episodeThroughput(void);
+
+    // A minute of rewind history: memory against storing every state, and
+    // the cost of stepping back, with every rewound state checked
+    //
+    [[nodiscard]] int rewindHistory(void);
+
+    // A multi-million-pipe level: time to open it, and the cost and
+    // working set of streaming every pipe through the game, each checked
+    // against the file
+    //
+    [[nodiscard]] int levelStreaming(void);
+
+    // Two rollback sessions racing over loopback UDP under injected lag and
+    // loss, checked against a replay of the inputs both sides really sent
+    //
+    [[nodiscard]] int versusLoopback(void);
+
+    // Many writer processes hammering one leaderboard file, checked against
+    // the expected top scores
+    //
+    [[nodiscard]] int leaderboardStress(const int writerCount);
+
+    // Child side of the stress test
+    //
+    [[nodiscard]] int leaderboardWriter(const std::string& path, const int writerIndex);
+}
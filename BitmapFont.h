@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+
+// BitmapFont
+// Built-in 8x8 font for printable ASCII plus the block glyphs the game
+// draws with. Rows run top to bottom, bit 0 is the leftmost pixel.
+//
+namespace BitmapFont
+{
+    constexpr int m_glyphWidth = 8;
+    constexpr int m_glyphHeight = 8;
+
+    [[nodiscard]] const uint8_t* glyph(const wchar_t character);
+}
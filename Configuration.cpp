@@ -0,0 +1,140 @@
+#include "Configuration.h"
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+
+
+namespace
+{
+    std::string_view trim(std::string_view text)
+    {
+        const auto first = text.find_first_not_of(" \t\r");
+
+        if (first == std::string_view::npos)
+        {
+            return {};
+        }
+
+        const auto last = text.find_last_not_of(" \t\r");
+
+        return text.substr(first, last - first + 1);
+    }
+
+    template <typename T>
+    bool parse(const std::string_view text, T& value)
+    {
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+}
+
+
+// Is Key
+//
+bool Configuration::isKey(const std::string_view key)
+{
+    return key == "jump-velocity"
+        || key == "pipe-velocity"
+        || key == "gravity"
+        || key == "seed"
+        || key == "width"
+        || key == "height";
+}
+
+
+// Set
+//
+bool Configuration::set(const std::string_view key, const std::string_view value)
+{
+    bool valid = false;
+
+    if (key == "jump-velocity")
+    {
+        valid = parse(value, m_parameters.m_jumpVelocity);
+    }
+    else if (key == "pipe-velocity")
+    {
+        valid = parse(value, m_parameters.m_pipeVelocity) && m_parameters.m_pipeVelocity > 0.0;
+    }
+    else if (key == "gravity")
+    {
+        valid = parse(value, m_parameters.m_gravity);
+    }
+    else if (key == "seed")
+    {
+        uint64_t seed = 0;
+        valid = parse(value, seed);
+        m_seed = seed;
+    }
+    else if (key == "width")
+    {
+        valid = parse(value, m_parameters.m_width)
+             && m_parameters.m_width >= GameParameters::m_minWidth
+             && m_parameters.m_width <= GameParameters::m_maxSize;
+    }
+    else if (key == "height")
+    {
+        valid = parse(value, m_parameters.m_height)
+             && m_parameters.m_height >= GameParameters::m_minHeight
+             && m_parameters.m_height <= GameParameters::m_maxSize;
+    }
+
+    // Anything given up front means the game should start without asking
+    m_parametersSupplied = true;
+
+    if (!valid)
+    {
+        std::cout << "Invalid value for " << key << ": " << value << std::endl;
+    }
+
+    return valid;
+}
+
+
+// Load File
+//
+bool Configuration::loadFile(const std::string& path)
+{
+    std::ifstream file(path);
+
+    if (!file)
+    {
+        std::cout << "Unable to open config file: " << path << std::endl;
+
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+
+        std::string_view text = line;
+        text = trim(text.substr(0, text.find('#')));
+
+        if (text.empty())
+        {
+            continue;
+        }
+
+        const auto equals = text.find('=');
+
+        if (equals == std::string_view::npos || !Configuration::isKey(trim(text.substr(0, equals))))
+        {
+            std::cout << path << ":" << lineNumber << ": expected key = value" << std::endl;
+
+            return false;
+        }
+
+        if (!this->set(trim(text.substr(0, equals)), trim(text.substr(equals + 1))))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+// Configuration
+// Game parameters from the command line or a config file. Any key
+// supplied this way skips the interactive prompts, and the physics not
+// given keep their defaults.
+//
+struct Configuration
+{
+    GameParameters m_parameters;
+    std::optional<uint64_t> m_seed;
+    bool m_parametersSupplied = false;
+
+    // Set
+    // Keys: jump-velocity, pipe-velocity, gravity, seed, width, height.
+    //
+    [[nodiscard]] bool set(const std::string_view key, const std::string_view value);
+
+    // Load File
+    // One "key = value" per line; '#' starts a comment.
+    //
+    [[nodiscard]] bool loadFile(const std::string& path);
+
+    [[nodiscard]] static bool isKey(const std::string_view key);
+};
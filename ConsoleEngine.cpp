@@ -1,8 +1,8 @@
 #include "ConsoleEngine.hpp"
+#include "Trace.h"
 #include <algorithm>
 #include <chrono>
 #include <iostream>
-#include <thread>
 
 
 // width
@@ -14,10 +14,35 @@ int Utilities::computeTheOffset(const int row, const int col, const int width)
 }
 
 
+// drawStringToBuffer
+// Draws the given string at the given position of any cell buffer.
+//
+void Utilities::drawStringToBuffer(
+    std::vector<CHAR_INFO>& buffer,
+    const int width,
+    const std::wstring& string,
+    const int row,
+    const int col)
+{
+    int i = 0;
+    int offset = Utilities::computeTheOffset(row, col, width);
+
+    for (; i < string.length(); ++offset, ++i)
+    {
+        CHAR_INFO charInfo;
+        charInfo.Attributes = 7;
+        charInfo.Char.UnicodeChar = string.at(i);
+        buffer.at(offset) = charInfo;
+    }
+}
+
+
 // Constructor
 //
 ConsoleEngine::ConsoleEngine(const std::wstring& title, const int width, const int height)
 : m_running(false),
+  m_clearEachFrame(true),
+  m_virtualTerminalOutput(false),
   m_fps(0.0),
   m_width(width),
   m_height(height),
@@ -26,7 +51,9 @@ ConsoleEngine::ConsoleEngine(const std::wstring& title, const int width, const i
   m_outputBuffer({}),
   m_inputBuffer({}),
   m_inputCommands({}),
-  m_title(title)
+  m_title(title),
+  m_measureStartup(false),
+  m_startupMilliseconds(-1.0)
 {
     // Nothing else to do
 }
@@ -58,6 +85,11 @@ int ConsoleEngine::gameLoop(void)
 
     this->onGameBegin();
 
+    if (m_measureStartup)
+    {
+        return EXIT_SUCCESS;
+    }
+
     while (true)
     {
         this->resetGameState();
@@ -67,6 +99,8 @@ int ConsoleEngine::gameLoop(void)
 
         while (m_running)
         {
+            TRACE_SCOPE("ConsoleEngine::frame");
+
             // Compute delta time
             auto timeNow = timer.now();
             auto deltaTimeMicro = duration_cast<microseconds>(timeNow - lastFrame).count();
@@ -74,8 +108,11 @@ int ConsoleEngine::gameLoop(void)
             lastFrame = timeNow;
             m_fps = 1.0 / deltaTimeSeconds;
 
-            // Clear any stale data
-            this->clearOutputBuffer();
+            // Clear any stale data, unless the game repaints every cell itself
+            if (m_clearEachFrame)
+            {
+                this->clearOutputBuffer();
+            }
 
             // Get user input
             if (!this->input())
@@ -164,35 +201,47 @@ bool ConsoleEngine::initializeConsole(void)
         return false;
     }
 
-    // Sleep, otherwise we run to fast to center the window
-    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    // Frames sent as UTF-8 escape sequences need the console to interpret them
+    if (m_virtualTerminalOutput)
+    {
+        DWORD outputMode = 0;
+
+        if (!GetConsoleMode(m_stdOutput, &outputMode)
+            || !SetConsoleMode(m_stdOutput, outputMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING)
+            || !SetConsoleOutputCP(CP_UTF8))
+        {
+            std::cout << "Unable to enable virtual terminal output." << std::endl;
 
-    // Keep the same initial dimensions
+            return false;
+        }
+    }
+
+    // Center the window. Ask the console for its window directly rather
+    // than searching by title, which needed the new title to propagate first.
     RECT windowRectangle;
-    WCHAR consoleTitle[50];
-    GetConsoleTitle(consoleTitle, 50);
-    HWND windowHandle = FindWindow(nullptr, consoleTitle);
-    GetWindowRect(windowHandle, &windowRectangle);
-
-    // Get the screen dimensions
-    const int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    const int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-    const int centerWidth = screenWidth / 2;
-    const int centerHeight = screenHeight / 2;
-
-    // Calculate new top
-    const int width = windowRectangle.right - windowRectangle.left;
-    const int height = windowRectangle.bottom - windowRectangle.top;
-
-    // Center the window
-    SetWindowPos(
-        windowHandle,
-        nullptr,
-        centerWidth - (width / 2),
-        centerHeight - (height / 2),
-        width,
-        height,
-        NULL);
+    HWND windowHandle = GetConsoleWindow();
+
+    if (windowHandle != nullptr && GetWindowRect(windowHandle, &windowRectangle))
+    {
+        // Get the screen dimensions
+        const int screenWidth = GetSystemMetrics(SM_CXSCREEN);
+        const int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+        const int centerWidth = screenWidth / 2;
+        const int centerHeight = screenHeight / 2;
+
+        // Keep the same initial dimensions
+        const int width = windowRectangle.right - windowRectangle.left;
+        const int height = windowRectangle.bottom - windowRectangle.top;
+
+        SetWindowPos(
+            windowHandle,
+            nullptr,
+            centerWidth - (width / 2),
+            centerHeight - (height / 2),
+            width,
+            height,
+            SWP_NOSIZE | SWP_NOZORDER);
+    }
 
     // Initialize buffers
     this->initializeOutputBuffer();
@@ -217,15 +266,108 @@ bool ConsoleEngine::render(void)
         return false;
     }
 
+    this->notePresented();
+
     return true;
 }
 
 
+// presentVirtualTerminal
+// Presents a frame the game has already encoded as escape sequences, in
+// a single write.
+//
+bool ConsoleEngine::presentVirtualTerminal(const std::string& bytes)
+{
+    TRACE_SCOPE("ConsoleEngine::presentVirtualTerminal");
+
+    DWORD written = 0;
+
+    if (!bytes.empty() && !WriteFile(m_stdOutput, bytes.data(), static_cast<DWORD>(bytes.size()), &written, nullptr))
+    {
+        std::cout << "Unable to write to the console." << std::endl;
+
+        return false;
+    }
+
+    this->notePresented();
+
+    return true;
+}
+
+
+// notePresented
+// Records the time of the first frame on screen.
+//
+void ConsoleEngine::notePresented(void)
+{
+    if (m_startupMilliseconds < 0.0)
+    {
+        m_startupMilliseconds = this->millisecondsSinceProcessStart();
+    }
+}
+
+
+// measureStartup
+// Quit as soon as the first frame is on screen.
+//
+void ConsoleEngine::measureStartup(void)
+{
+    m_measureStartup = true;
+}
+
+
+// startupMilliseconds
+// Time from process creation to the first presented frame, or -1.
+//
+double ConsoleEngine::startupMilliseconds(void) const
+{
+    return m_startupMilliseconds;
+}
+
+
+// measuringStartup
+// Accessor for m_measureStartup
+//
+bool ConsoleEngine::measuringStartup(void) const
+{
+    return m_measureStartup;
+}
+
+
+// millisecondsSinceProcessStart
+//
+double ConsoleEngine::millisecondsSinceProcessStart(void) const
+{
+    FILETIME creation;
+    FILETIME exit;
+    FILETIME kernel;
+    FILETIME user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    {
+        return 0.0;
+    }
+
+    FILETIME now;
+    GetSystemTimePreciseAsFileTime(&now);
+
+    auto toTicks = [](const FILETIME& time) -> uint64_t
+    {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+
+    // FILETIME counts 100 ns ticks
+    return static_cast<double>(toTicks(now) - toTicks(creation)) * 1e-4;
+}
+
+
 // initializeConsole
 // Returns a vector of user inputs
 //
 bool ConsoleEngine::input(void)
 {
+    TRACE_SCOPE("ConsoleEngine::input");
+
     m_inputCommands.clear();
     m_inputBuffer.clear();
 
@@ -263,7 +405,15 @@ bool ConsoleEngine::input(void)
     {
         const auto inputEvent = this->extractInputEvent(input);
 
-        if (inputEvent != Input::NONE)
+        if (inputEvent == Input::TRACE)
+        {
+            // Handled by the engine, the game never sees it
+            if (!Trace::flush())
+            {
+                std::cout << "Unable to write the trace." << std::endl;
+            }
+        }
+        else if (inputEvent != Input::NONE)
         {
             m_inputCommands.push_back(inputEvent);
         }
@@ -273,6 +423,33 @@ bool ConsoleEngine::input(void)
 }
 
 
+// waitForInput
+// Sleeps until the console has input or the timeout passes, then reads it.
+// For screens that only change on a key press, so they cost no CPU while
+// idle. Any console event wakes the wait, so m_inputCommands may be empty.
+//
+bool ConsoleEngine::waitForInput(const DWORD timeoutMilliseconds)
+{
+    const DWORD result = WaitForSingleObject(m_stdInput, timeoutMilliseconds);
+
+    if (result == WAIT_FAILED)
+    {
+        std::cout << "Error waiting for console input." << std::endl;
+
+        return false;
+    }
+
+    if (result == WAIT_TIMEOUT)
+    {
+        m_inputCommands.clear();
+
+        return true;
+    }
+
+    return this->input();
+}
+
+
 // width
 // Accessor for m_width
 //
@@ -299,16 +476,7 @@ void ConsoleEngine::drawStringToBuffer(
     const int row,
     const int col)
 {
-    int i = 0;
-    int offset = this->computeOffset(row, col);
-
-    for (; i < string.length(); ++offset, ++i)
-    {
-        CHAR_INFO charInfo;
-        charInfo.Attributes = 7;
-        charInfo.Char.UnicodeChar = string.at(i);
-        m_outputBuffer.at(offset) = charInfo;
-    }
+    Utilities::drawStringToBuffer(m_outputBuffer, m_width, string, row, col);
 }
 
 
@@ -351,6 +519,8 @@ void ConsoleEngine::initializeInputBuffer(void)
 //
 void ConsoleEngine::clearOutputBuffer(void)
 {
+    TRACE_SCOPE("ConsoleEngine::clearOutputBuffer");
+
     std::for_each(
         m_outputBuffer.begin(),
         m_outputBuffer.end(),
@@ -365,6 +535,8 @@ void ConsoleEngine::clearOutputBuffer(void)
 //
 bool ConsoleEngine::writeToConsole(void)
 {
+    TRACE_SCOPE("ConsoleEngine::writeToConsole");
+
     const short width = static_cast<short>(m_width);
     const short height = static_cast<short>(m_height);
 
@@ -422,15 +594,24 @@ ConsoleEngine::Input ConsoleEngine::extractInputEvent(const INPUT_RECORD& input)
 //
 ConsoleEngine::Input ConsoleEngine::extractKeyEvent(const KEY_EVENT_RECORD& keyEvent)
 {
+    // Rewind lasts as long as the key is held, so its release counts too
+    if (keyEvent.wVirtualKeyCode == 'R')
+    {
+        return keyEvent.bKeyDown ? ConsoleEngine::Input::REWIND : ConsoleEngine::Input::REWIND_END;
+    }
+
     if (!keyEvent.bKeyDown)
     {
         return ConsoleEngine::Input::NONE;
     }
 
-    // Q Mapping
+    // Q, T, Y and N Mapping
     switch (keyEvent.uChar.UnicodeChar)
     {
         case L'q': return ConsoleEngine::Input::QUIT;
+        case L't': return ConsoleEngine::Input::TRACE;
+        case L'y': return ConsoleEngine::Input::YES;
+        case L'n': return ConsoleEngine::Input::NO;
         default:   break;
     }
 
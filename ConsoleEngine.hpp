@@ -8,6 +8,12 @@
 namespace Utilities
 {
     [[nodiscard]] int computeTheOffset(const int row, const int col, const int width);
+    void drawStringToBuffer(
+        std::vector<CHAR_INFO>& buffer,
+        const int width,
+        const std::wstring& string,
+        const int row,
+        const int col);
 }
 
 class ConsoleEngine
@@ -15,10 +21,15 @@ class ConsoleEngine
 public:
     enum class Input
     {
-        UNDEFINED = -1,
-        NONE      = 0,
-        QUIT      = 1,
-        JUMP      = 2
+        UNDEFINED  = -1,
+        NONE       = 0,
+        QUIT       = 1,
+        JUMP       = 2,
+        TRACE      = 3,
+        YES        = 4,
+        NO         = 5,
+        REWIND     = 6, // 'r' pressed or repeating
+        REWIND_END = 7  // 'r' released
     };
 
     enum class PlayAgain
@@ -38,19 +49,26 @@ public:
 
     [[nodiscard]] bool initializeConsole(void);
     [[nodiscard]] int gameLoop(void);
+    void measureStartup(void);
+    [[nodiscard]] double startupMilliseconds(void) const;
 
 protected:
     [[nodiscard]] virtual bool update(const double deltaTime) = 0;
     [[nodiscard]] virtual bool render(void);
     virtual void resetGameState(void) = 0;
     virtual void onGameBegin(void) = 0;
-    [[nodiscard]] virtual PlayAgain onGameEnd(void) const = 0;
+    [[nodiscard]] virtual PlayAgain onGameEnd(void) = 0;
     [[nodiscard]] bool input(void);
+    [[nodiscard]] bool waitForInput(const DWORD timeoutMilliseconds);
+    [[nodiscard]] bool presentVirtualTerminal(const std::string& bytes);
     [[nodiscard]] int width(void) const;
     [[nodiscard]] int height(void) const;
+    [[nodiscard]] bool measuringStartup(void) const;
     void drawStringToBuffer(const std::wstring& string, const int row, const int col);
 
     bool m_running;
+    bool m_clearEachFrame;
+    bool m_virtualTerminalOutput;
     double m_fps;
     int m_width;
     int m_height;
@@ -62,8 +80,10 @@ private:
     void initializeInputBuffer(void);
     void clearOutputBuffer(void);
     bool writeToConsole(void);
+    void notePresented(void);
     void flushConsole(void);
     [[nodiscard]] int computeOffset(const int row, const int col) const;
+    [[nodiscard]] double millisecondsSinceProcessStart(void) const;
     [[nodiscard]] ConsoleEngine::Input extractInputEvent(const INPUT_RECORD& input);
     [[nodiscard]] ConsoleEngine::Input extractKeyEvent(const KEY_EVENT_RECORD& keyEvent);
 
@@ -71,4 +91,6 @@ private:
     HANDLE m_stdOutput;
     std::vector<INPUT_RECORD> m_inputBuffer;
     const std::wstring m_title;
+    bool m_measureStartup;
+    double m_startupMilliseconds;
 };
@@ -0,0 +1,36 @@
+#include "Cpu.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+// Has AVX2
+// Checked once; callers fall back to their portable path otherwise.
+//
+bool Cpu::hasAVX2(void)
+{
+#if defined(_MSC_VER)
+    static const bool supported = []()
+    {
+        int info[4] = {};
+        __cpuid(info, 0);
+
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        __cpuid(info, 1);
+        const bool osSavesYmm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 6) == 6);
+
+        __cpuidex(info, 7, 0);
+
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+    }();
+
+    return supported;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
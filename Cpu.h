@@ -0,0 +1,17 @@
+#pragma once
+
+#if defined(_MSC_VER)
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+
+// Cpu
+// Runtime instruction set checks for the vectorized kernels. Functions
+// marked TARGET_AVX2 must only be called when hasAVX2() is true.
+//
+namespace Cpu
+{
+    [[nodiscard]] bool hasAVX2(void);
+}
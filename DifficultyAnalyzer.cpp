@@ -0,0 +1,462 @@
+#include "DifficultyAnalyzer.h"
+#include "Cpu.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <immintrin.h>
+#include <thread>
+
+
+namespace
+{
+    // Chains longer than this keep re-applying their last shift
+    constexpr int MAX_CHAIN_LENGTH = 4096;
+
+    uint64_t shiftLeft(const uint64_t value, const int count)
+    {
+        return count >= 64 ? 0 : value << count;
+    }
+
+    uint64_t shiftRight(const uint64_t value, const int count)
+    {
+        return count >= 64 ? 0 : value >> count;
+    }
+}
+
+
+// Constructor
+//
+DifficultyAnalyzer::DifficultyAnalyzer(const GameParameters& parameters, const double tickSeconds)
+: m_parameters(parameters),
+  m_tickSeconds(tickSeconds),
+  m_subRowsPerRow(std::clamp(m_maxSubRows / std::max(parameters.m_height, 1), 1, 8)),
+  m_subRows(0),
+  m_useAVX2(DifficultyAnalyzer::usesAVX2()),
+  m_startChain(),
+  m_jumpChain()
+{
+    m_subRows = std::min(m_subRowsPerRow * m_parameters.m_height, static_cast<int>(m_maxSubRows));
+
+    this->buildChain(m_jumpChain, m_parameters.m_jumpVelocity);
+    this->buildChain(m_startChain, 0.0);
+}
+
+
+// Uses AVX2
+//
+bool DifficultyAnalyzer::usesAVX2(void)
+{
+    return Cpu::hasAVX2();
+}
+
+
+// Pipes Passable
+//
+int DifficultyAnalyzer::pipesPassable(const GameState& start, const int targetPipes)
+{
+    if (m_parameters.m_height * m_subRowsPerRow > m_maxSubRows)
+    {
+        return 0; // Too tall to analyze
+    }
+
+    this->buildChain(m_startChain, start.m_verticalVelocity);
+
+    for (Bits& bits : m_jumpChain.m_reach)
+    {
+        bits = Bits();
+    }
+
+    m_jumpChain.m_highest = -1;
+
+    const int startSubRow = static_cast<int>(std::floor((start.m_rowDouble + 0.5) * m_subRowsPerRow));
+
+    if (startSubRow < 0 || startSubRow >= m_subRows)
+    {
+        return 0;
+    }
+
+    m_startChain.m_reach[0] = this->rangeBits(startSubRow, startSubRow + 1);
+    m_startChain.m_highest = 0;
+
+    // Pipes move the same whatever the bird does, so the course is simply
+    // stepped alongside and only its pipes are looked at
+    GameState course = start;
+
+    while (course.m_score < static_cast<size_t>(targetPipes))
+    {
+        Simulation::step(course, m_parameters, false, m_tickSeconds);
+
+        if (!this->advance(this->allowedBits(course)))
+        {
+            break;
+        }
+    }
+
+    return static_cast<int>(std::min(course.m_score, static_cast<size_t>(targetPipes)));
+}
+
+
+// Is Passable
+//
+bool DifficultyAnalyzer::isPassable(const GameState& start, const int targetPipes)
+{
+    return this->pipesPassable(start, targetPipes) >= targetPipes;
+}
+
+
+// Analyze
+//
+DifficultyReport DifficultyAnalyzer::analyze(const uint64_t firstSeed, const int courses, const int targetPipes)
+{
+    DifficultyReport report;
+    report.m_parameters = m_parameters;
+    report.m_courses = courses;
+    report.m_targetPipes = targetPipes;
+
+    int passed = 0;
+    double pipes = 0.0;
+
+    for (int i = 0; i < courses; ++i)
+    {
+        GameState course;
+        course.m_random.seed(firstSeed + i);
+        Simulation::reset(course, m_parameters);
+
+        const int passable = this->pipesPassable(course, targetPipes);
+        pipes += passable;
+
+        if (passable >= targetPipes)
+        {
+            ++passed;
+        }
+    }
+
+    if (courses > 0)
+    {
+        report.m_survivalProbability = static_cast<double>(passed) / courses;
+        report.m_meanPipesPassed = pipes / courses;
+    }
+
+    return report;
+}
+
+
+// Sweep
+//
+std::vector<DifficultyReport> DifficultyAnalyzer::sweep(
+    const std::vector<GameParameters>& parameterSets,
+    const double tickSeconds,
+    const uint64_t firstSeed,
+    const int courses,
+    const int targetPipes,
+    const int threadCount)
+{
+    std::vector<DifficultyReport> reports(parameterSets.size());
+    std::atomic<size_t> next = 0;
+
+    auto worker = [&](void)
+    {
+        for (size_t i = next++; i < parameterSets.size(); i = next++)
+        {
+            DifficultyAnalyzer analyzer(parameterSets[i], tickSeconds);
+            reports[i] = analyzer.analyze(firstSeed, courses, targetPipes);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(std::max(threadCount, 1));
+
+    for (int i = 0; i < std::max(threadCount, 1); ++i)
+    {
+        workers.emplace_back(worker);
+    }
+
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    return reports;
+}
+
+
+// Build Chain
+// Integrates a velocity chain exactly as Simulation::step does. Shifts
+// come from the rounded running displacement, so rounding never
+// accumulates along a chain.
+//
+void DifficultyAnalyzer::buildChain(Chain& chain, const double initialVelocity) const
+{
+    chain.m_plans.clear();
+    chain.m_plans.emplace_back(); // Entry 0 has no predecessor
+
+    double velocity = initialVelocity;
+    double displacement = 0.0;
+    long long previous = 0;
+
+    while (static_cast<int>(chain.m_plans.size()) < MAX_CHAIN_LENGTH)
+    {
+        velocity = velocity - (m_parameters.m_gravity * m_tickSeconds);
+        displacement -= velocity * m_tickSeconds * m_subRowsPerRow;
+
+        const long long rounded = std::llround(displacement);
+
+        // Past this point every starting sub-row has left the field
+        if (std::llabs(rounded) >= m_subRows && chain.m_plans.size() >= 2)
+        {
+            break;
+        }
+
+        ShiftPlan plan;
+        plan.m_shift = static_cast<int>(std::clamp<long long>(rounded - previous, -m_maxSubRows, m_maxSubRows));
+
+        const int distance = std::abs(plan.m_shift);
+        const int lanes = distance / 64;
+        const int bits = distance % 64;
+        const int carry = (bits == 0) ? 64 : 64 - bits;
+
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            // Towards higher sub-rows reads lower lanes, and vice versa
+            const int primary = (plan.m_shift >= 0) ? lane - lanes : lane + lanes;
+            const int secondary = (plan.m_shift >= 0) ? primary - 1 : primary + 1;
+
+            const bool primaryValid = primary >= 0 && primary < 4 && distance < m_maxSubRows;
+            const bool secondaryValid = secondary >= 0 && secondary < 4 && distance < m_maxSubRows;
+
+            plan.m_primaryIndex[lane * 2] = primaryValid ? primary * 2 : 0;
+            plan.m_primaryIndex[lane * 2 + 1] = primaryValid ? primary * 2 + 1 : 0;
+            plan.m_secondaryIndex[lane * 2] = secondaryValid ? secondary * 2 : 0;
+            plan.m_secondaryIndex[lane * 2 + 1] = secondaryValid ? secondary * 2 + 1 : 0;
+            plan.m_primaryMask[lane] = primaryValid ? ~0ull : 0;
+            plan.m_secondaryMask[lane] = secondaryValid ? ~0ull : 0;
+        }
+
+        if (plan.m_shift >= 0)
+        {
+            plan.m_primaryLeft = bits;
+            plan.m_secondaryRight = carry;
+        }
+        else
+        {
+            plan.m_primaryRight = bits;
+            plan.m_secondaryLeft = carry;
+        }
+
+        chain.m_plans.push_back(plan);
+        previous = rounded;
+    }
+
+    chain.m_reach.assign(chain.m_plans.size(), Bits());
+    chain.m_highest = -1;
+}
+
+
+// Allowed Bits
+// Sub-rows where the bird is on screen and clear of every pipe.
+//
+DifficultyAnalyzer::Bits DifficultyAnalyzer::allowedBits(const GameState& course) const
+{
+    int firstRow = 0;
+    int lastRow = m_parameters.m_height;
+
+    for (const Pipe& pipe : course.m_pipes)
+    {
+        const bool coversBird = pipe.isVisible(m_parameters.m_width)
+                             && course.m_col >= pipe.m_col
+                             && course.m_col < pipe.m_col + pipe.m_width;
+
+        if (coversBird)
+        {
+            firstRow = std::max(firstRow, pipe.m_gapStartRow);
+            lastRow = std::min(lastRow, pipe.m_gapStartRow + pipe.m_gapSize);
+        }
+    }
+
+    return this->rangeBits(firstRow * m_subRowsPerRow, lastRow * m_subRowsPerRow);
+}
+
+
+// Range Bits
+// Bits [firstSubRow, lastSubRow) set.
+//
+DifficultyAnalyzer::Bits DifficultyAnalyzer::rangeBits(const int firstSubRow, const int lastSubRow) const
+{
+    Bits bits;
+
+    for (int word = 0; word < 4; ++word)
+    {
+        const int low = std::clamp(firstSubRow - (word * 64), 0, 64);
+        const int high = std::clamp(lastSubRow - (word * 64), 0, 64);
+
+        if (high > low)
+        {
+            const uint64_t upTo = (high == 64) ? ~0ull : ((1ull << high) - 1);
+            bits.m_words[word] = upTo & ~((1ull << low) - 1);
+        }
+    }
+
+    return bits;
+}
+
+
+// Advance
+// One tick for every live state. Returns whether any state survived.
+//
+bool DifficultyAnalyzer::advance(const Bits& allowed)
+{
+    // Jumping is possible from every live state
+    Bits anyState;
+
+    for (const Chain* chain : { &m_startChain, &m_jumpChain })
+    {
+        for (int k = 0; k <= chain->m_highest; ++k)
+        {
+            for (int word = 0; word < 4; ++word)
+            {
+                anyState.m_words[word] |= chain->m_reach[k].m_words[word];
+            }
+        }
+    }
+
+    bool alive = false;
+
+    for (Chain* chain : { &m_startChain, &m_jumpChain })
+    {
+        if (chain->m_highest < 0)
+        {
+            continue;
+        }
+
+        const int last = static_cast<int>(chain->m_reach.size()) - 1;
+        int highest = -1;
+        Bits saturated;
+
+        if (chain->m_highest == last && last > 0)
+        {
+            this->shift(chain->m_plans[last], chain->m_reach[last], saturated);
+        }
+
+        // Walk down so each entry is read before it is overwritten
+        for (int k = std::min(chain->m_highest, last - 1); k >= 0; --k)
+        {
+            Bits& target = chain->m_reach[k + 1];
+            this->shift(chain->m_plans[k + 1], chain->m_reach[k], target);
+
+            uint64_t any = 0;
+
+            for (int word = 0; word < 4; ++word)
+            {
+                target.m_words[word] &= allowed.m_words[word];
+                any |= target.m_words[word];
+            }
+
+            if (any != 0 && highest < 0)
+            {
+                highest = k + 1;
+            }
+        }
+
+        chain->m_reach[0] = Bits();
+
+        if (chain->m_highest == last && last > 0)
+        {
+            uint64_t any = 0;
+
+            for (int word = 0; word < 4; ++word)
+            {
+                chain->m_reach[last].m_words[word] |= saturated.m_words[word] & allowed.m_words[word];
+                any |= chain->m_reach[last].m_words[word];
+            }
+
+            if (any != 0)
+            {
+                highest = last;
+            }
+        }
+
+        chain->m_highest = highest;
+        alive = alive || (highest >= 0);
+    }
+
+    // The jump itself
+    Bits jumped;
+    this->shift(m_jumpChain.m_plans[1], anyState, jumped);
+
+    uint64_t any = 0;
+
+    for (int word = 0; word < 4; ++word)
+    {
+        m_jumpChain.m_reach[1].m_words[word] |= jumped.m_words[word] & allowed.m_words[word];
+        any |= m_jumpChain.m_reach[1].m_words[word];
+    }
+
+    if (any != 0)
+    {
+        m_jumpChain.m_highest = std::max(m_jumpChain.m_highest, 1);
+        alive = true;
+    }
+
+    return alive;
+}
+
+
+// Shift
+//
+void DifficultyAnalyzer::shift(const ShiftPlan& plan, const Bits& input, Bits& output) const
+{
+    if (m_useAVX2)
+    {
+        DifficultyAnalyzer::shiftAVX2(plan, input, output);
+    }
+    else
+    {
+        DifficultyAnalyzer::shiftScalar(plan, input, output);
+    }
+}
+
+
+// Shift Scalar
+//
+void DifficultyAnalyzer::shiftScalar(const ShiftPlan& plan, const Bits& input, Bits& output)
+{
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        const uint64_t primary = input.m_words[plan.m_primaryIndex[lane * 2] / 2] & plan.m_primaryMask[lane];
+        const uint64_t secondary = input.m_words[plan.m_secondaryIndex[lane * 2] / 2] & plan.m_secondaryMask[lane];
+
+        output.m_words[lane] = shiftLeft(primary, plan.m_primaryLeft)
+                             | shiftRight(primary, plan.m_primaryRight)
+                             | shiftLeft(secondary, plan.m_secondaryLeft)
+                             | shiftRight(secondary, plan.m_secondaryRight);
+    }
+}
+
+
+// Shift AVX2
+// The whole 256-bit set in one register: two lane permutes pick the
+// source words, then variable 64-bit shifts (zero for counts >= 64).
+//
+TARGET_AVX2 void DifficultyAnalyzer::shiftAVX2(const ShiftPlan& plan, const Bits& input, Bits& output)
+{
+    const __m256i words = _mm256_load_si256(reinterpret_cast<const __m256i*>(input.m_words));
+
+    const __m256i primary = _mm256_and_si256(
+        _mm256_permutevar8x32_epi32(words, _mm256_load_si256(reinterpret_cast<const __m256i*>(plan.m_primaryIndex))),
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(plan.m_primaryMask)));
+
+    const __m256i secondary = _mm256_and_si256(
+        _mm256_permutevar8x32_epi32(words, _mm256_load_si256(reinterpret_cast<const __m256i*>(plan.m_secondaryIndex))),
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(plan.m_secondaryMask)));
+
+    const __m256i result = _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_sll_epi64(primary, _mm_cvtsi32_si128(plan.m_primaryLeft)),
+            _mm256_srl_epi64(primary, _mm_cvtsi32_si128(plan.m_primaryRight))),
+        _mm256_or_si256(
+            _mm256_sll_epi64(secondary, _mm_cvtsi32_si128(plan.m_secondaryLeft)),
+            _mm256_srl_epi64(secondary, _mm_cvtsi32_si128(plan.m_secondaryRight))));
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(output.m_words), result);
+}
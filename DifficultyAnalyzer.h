@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <cstdint>
+#include <vector>
+
+
+struct DifficultyReport
+{
+    GameParameters m_parameters;
+    int m_courses = 0;
+    int m_targetPipes = 0;
+    double m_survivalProbability = 0.0; // Courses where the target was reachable
+    double m_meanPipesPassed = 0.0;     // With perfect play
+};
+
+
+// DifficultyAnalyzer
+// Offline reachability over the bird's (row, velocity) state space. Rows
+// are split into sub-rows held as one 256-bit set per velocity, so a tick
+// is a shift and mask of each set. Velocity is tracked exactly as the
+// number of ticks since the last jump (or since the start), integrated
+// the same way as Simulation::step.
+//
+class DifficultyAnalyzer
+{
+public:
+    static constexpr int m_maxSubRows = 256;
+
+    // Deleted Special Member Functions
+    //
+    DifficultyAnalyzer(void) = delete;
+    DifficultyAnalyzer(const DifficultyAnalyzer& RHS) = delete;
+    DifficultyAnalyzer(DifficultyAnalyzer&& RHS) = delete;
+    DifficultyAnalyzer& operator=(const DifficultyAnalyzer& RHS) = delete;
+    DifficultyAnalyzer& operator=(DifficultyAnalyzer&& RHS) = delete;
+
+    // Constructor
+    // Fields taller than m_maxSubRows rows are not supported.
+    //
+    DifficultyAnalyzer(const GameParameters& parameters, const double tickSeconds);
+
+    // Destructor
+    //
+    ~DifficultyAnalyzer(void) = default;
+
+    // Pipes Passable
+    // How many pipes of this course some input sequence gets past, up to
+    // targetPipes. The bird starts from the state's row, at rest.
+    //
+    [[nodiscard]] int pipesPassable(const GameState& start, const int targetPipes);
+
+    // Is Passable
+    //
+    [[nodiscard]] bool isPassable(const GameState& start, const int targetPipes);
+
+    // Analyze
+    // Runs random courses seeded firstSeed, firstSeed + 1, ...
+    //
+    [[nodiscard]] DifficultyReport analyze(const uint64_t firstSeed, const int courses, const int targetPipes);
+
+    // Sweep
+    // One analyzer per worker thread, parameter sets handed out in turn.
+    //
+    [[nodiscard]] static std::vector<DifficultyReport> sweep(
+        const std::vector<GameParameters>& parameterSets,
+        const double tickSeconds,
+        const uint64_t firstSeed,
+        const int courses,
+        const int targetPipes,
+        const int threadCount);
+
+    [[nodiscard]] static bool usesAVX2(void);
+
+private:
+    struct alignas(32) Bits
+    {
+        uint64_t m_words[4] = { 0, 0, 0, 0 };
+    };
+
+    // Precomputed shift by a fixed number of sub-rows
+    //
+    struct ShiftPlan
+    {
+        int m_shift = 0;
+        alignas(32) int32_t m_primaryIndex[8] = {};
+        alignas(32) int32_t m_secondaryIndex[8] = {};
+        alignas(32) uint64_t m_primaryMask[4] = {};
+        alignas(32) uint64_t m_secondaryMask[4] = {};
+        int m_primaryLeft = 64;
+        int m_primaryRight = 64;
+        int m_secondaryLeft = 64;
+        int m_secondaryRight = 64;
+    };
+
+    // One chain of velocities: entry k is "k ticks since the chain began"
+    //
+    struct Chain
+    {
+        std::vector<ShiftPlan> m_plans; // m_plans[k] takes entry k-1 to k
+        std::vector<Bits> m_reach;
+        int m_highest = -1;             // Highest non-empty entry
+    };
+
+    void buildChain(Chain& chain, const double initialVelocity) const;
+    [[nodiscard]] Bits allowedBits(const GameState& course) const;
+    [[nodiscard]] Bits rangeBits(const int firstSubRow, const int lastSubRow) const;
+    [[nodiscard]] bool advance(const Bits& allowed);
+
+    static void shiftScalar(const ShiftPlan& plan, const Bits& input, Bits& output);
+    static void shiftAVX2(const ShiftPlan& plan, const Bits& input, Bits& output);
+    void shift(const ShiftPlan& plan, const Bits& input, Bits& output) const;
+
+    GameParameters m_parameters;
+    double m_tickSeconds;
+    int m_subRowsPerRow;
+    int m_subRows;
+    bool m_useAVX2;
+    Chain m_startChain;
+    Chain m_jumpChain;
+};
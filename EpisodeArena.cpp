@@ -0,0 +1,38 @@
+#include "EpisodeArena.h"
+
+
+// Constructor
+// make_unique zeroes the block, which also makes its pages resident
+// before the first episode runs.
+//
+EpisodeArena::EpisodeArena(const size_t bytes)
+: m_capacity(bytes),
+  m_block(std::make_unique<std::byte[]>(bytes)),
+  m_resource(m_block.get(), bytes, std::pmr::new_delete_resource())
+{
+}
+
+
+// Reset
+// Also frees anything an oversized episode took from the heap.
+//
+void EpisodeArena::reset(void)
+{
+    m_resource.release();
+}
+
+
+// Resource
+//
+std::pmr::memory_resource* EpisodeArena::resource(void)
+{
+    return &m_resource;
+}
+
+
+// Capacity
+//
+size_t EpisodeArena::capacity(void) const
+{
+    return m_capacity;
+}
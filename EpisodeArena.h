@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+
+// EpisodeArena
+// Memory for the per-game objects of a batch of headless episodes (the
+// bot's beams, the replay frames). One arena per worker thread: each
+// episode allocates by bumping a pointer through the arena's block, and
+// reset() hands the whole block back at once for the next episode. The
+// block is touched once and then reused, so episodes neither take the
+// heap's lock nor fault in fresh pages. An episode that outgrows the
+// block carries on from the heap until the next reset.
+//
+class EpisodeArena
+{
+public:
+    // Deleted Special Member Functions
+    //
+    EpisodeArena(void) = delete;
+    EpisodeArena(const EpisodeArena& RHS) = delete;
+    EpisodeArena(EpisodeArena&& RHS) = delete;
+    EpisodeArena& operator=(const EpisodeArena& RHS) = delete;
+    EpisodeArena& operator=(EpisodeArena&& RHS) = delete;
+
+    // Constructor
+    //
+    explicit EpisodeArena(const size_t bytes);
+
+    // Destructor
+    //
+    ~EpisodeArena(void) = default;
+
+    // Reset
+    // Everything allocated since the last reset is gone; nothing from it
+    // may still be in use.
+    //
+    void reset(void);
+
+    // For the pmr containers of one episode
+    //
+    [[nodiscard]] std::pmr::memory_resource* resource(void);
+
+    [[nodiscard]] size_t capacity(void) const;
+
+private:
+    // Private Data Variables
+    //
+    size_t m_capacity;
+    std::unique_ptr<std::byte[]> m_block;
+    std::pmr::monotonic_buffer_resource m_resource;
+};
@@ -1,85 +1,242 @@
 #include "FlappyBird.h"
+#include "Scene.h"
+#include "Trace.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <vector>
 
 
 // Constructor
 //
 FlappyBird::FlappyBird(const std::wstring& title, const int width, const int height)
-: m_score(0),
-  m_verticalVelocity(0.0),
-  m_rowDouble(0.0),
+: m_state(),
   m_jump(false),
-  m_row(0),
-  m_col(0),
-  m_pipes({}),
-  m_jumpVelocity(0.0),
-  m_pipeVelocity(0.0),
-  m_gravity(0.0),
+  m_autopilot(nullptr),
+  m_autopilotTime(0.0),
+  m_replay(),
+  m_replayPath(),
+  m_leaderboard(nullptr),
+  m_field(width, height),
+  m_canvas(nullptr),
+  m_versus(nullptr),
+  m_compositor(nullptr),
+  m_history(nullptr),
+  m_occupancy(nullptr),
+  m_rays(),
+  m_rayDistances(),
+  m_level(nullptr),
+  m_rewinding(false),
+  m_practiceJump(false),
+  m_practiceTime(0.0),
+  m_parameters(),
+  m_promptForParameters(true),
   ConsoleEngine(title, width, height)
 {
+    m_parameters.m_width = width;
+    m_parameters.m_height = height;
+
+    // Both renderers write every cell themselves
+    m_clearEachFrame = false;
+
     this->resetGameState();
 }
 
 
+// Save
+//
+GameState FlappyBird::save(void) const
+{
+    return m_state;
+}
+
+
+// Restore
+//
+void FlappyBird::restore(const GameState& state)
+{
+    m_state = state;
+    m_running = m_state.m_running;
+}
+
+
+// Set Parameters
+// Physics come from the caller; the field size stays as constructed.
+//
+void FlappyBird::setParameters(const GameParameters& parameters)
+{
+    m_parameters.m_jumpVelocity = parameters.m_jumpVelocity;
+    m_parameters.m_pipeVelocity = parameters.m_pipeVelocity;
+    m_parameters.m_gravity = parameters.m_gravity;
+    m_promptForParameters = false;
+}
+
+
+// Set Seed
+//
+void FlappyBird::setSeed(const uint64_t seed)
+{
+    m_state.m_random.seed(seed);
+}
+
+
+// Enable Autopilot
+//
+void FlappyBird::enableAutopilot(void)
+{
+    constexpr int beamWidth = 32;
+    constexpr int depth = 12;
+    constexpr int ticksPerPly = 4;
+    constexpr double tickSeconds = 1.0 / 60.0;
+
+    m_autopilot = std::make_unique<Autopilot>(beamWidth, depth, ticksPerPly, tickSeconds);
+}
+
+
+// Enable Recording
+//
+void FlappyBird::enableRecording(const std::string& path)
+{
+    m_replayPath = path;
+}
+
+
+// Enable High Resolution
+//
+void FlappyBird::enableHighResolution(const PixelCanvas::Mode mode)
+{
+    m_canvas = std::make_unique<PixelCanvas>(mode, m_parameters.m_width, m_parameters.m_height);
+}
+
+
+// Enable Banded Compositor
+//
+void FlappyBird::enableBandedCompositor(const int threadCount)
+{
+    m_compositor = std::make_unique<BandedCompositor>(m_parameters.m_width, m_parameters.m_height, threadCount);
+    m_virtualTerminalOutput = true;
+}
+
+
+// Enable Versus
+// Plays on the autopilot's fixed tick. The port is bound now so a clash is
+// reported before the console is taken over.
+//
+bool FlappyBird::enableVersus(const VersusOptions& options)
+{
+    constexpr double tickSeconds = 1.0 / 60.0;
+
+    m_versus = std::make_unique<VersusMatch>(options, tickSeconds);
+
+    if (!m_versus->open())
+    {
+        m_versus.reset();
+
+        return false;
+    }
+
+    return true;
+}
+
+
+// Enable Practice
+// Rewinds at twice the speed it was played.
+//
+void FlappyBird::enablePractice(void)
+{
+    constexpr double tickSeconds = 1.0 / 120.0;
+    constexpr double seconds = 60.0;
+
+    m_history = std::make_unique<RewindHistory>(tickSeconds, seconds);
+}
+
+
+// Enable Sensors
+//
+void FlappyBird::enableSensors(const int rayCount)
+{
+    constexpr double maxDistance = 60.0;
+
+    m_occupancy = std::make_unique<OccupancyMap>(m_parameters.m_width, m_parameters.m_height);
+    m_rays = OccupancyMap::fan(rayCount, maxDistance);
+    m_rayDistances.assign(m_rays.size(), 0.0);
+}
+
+
+// Enable Level
+// Every game from the next on starts at the level's first pipe.
+//
+void FlappyBird::enableLevel(Level& level)
+{
+    level.apply(m_parameters);
+    m_level = &level;
+}
+
+
+// Enable Leaderboard
+// The game carries on without one if the file cannot be opened.
+//
+void FlappyBird::enableLeaderboard(const std::string& path)
+{
+    m_leaderboard = std::make_unique<Leaderboard>();
+
+    if (!m_leaderboard->open(path))
+    {
+        m_leaderboard.reset();
+    }
+}
+
+
 // Update
 //
 bool FlappyBird::update(const double deltaTime)
 {
+    TRACE_SCOPE("FlappyBird::update");
+
     this->handleInputEvents();
 
-    this->updatePhysics(deltaTime);
+    this->handleAutopilot(deltaTime);
 
-    if (m_row < 0 || m_row >= this->height())
+    // Whichever path below moves the course, what is behind it is done with
+    if (m_level != nullptr)
     {
-        m_running = false;
+        m_level->release(m_state.m_levelCursor);
     }
 
-    for (auto& pipe : m_pipes)
+    // The match owns both games; ours is copied out for the scene
+    if (m_versus != nullptr)
     {
-        pipe.updatePosition(deltaTime);
+        m_versus->update(deltaTime, m_jump);
+        m_state = m_versus->local();
 
-        // Update score
-        if ((!pipe.m_scoreTracked) && ((pipe.m_col + pipe.m_width) <= m_col))
+        if (m_versus->finished())
         {
-            ++m_score;
-            pipe.m_scoreTracked = true;
+            m_running = false;
         }
-    }
 
-    // Remove pipes that are output of field of view
-    std::vector<size_t> pipesToErase;
-    pipesToErase.reserve(m_pipes.size());
+        return true;
+    }
 
-    for (size_t i = 0; i < m_pipes.size(); ++i)
+    if (m_history != nullptr)
     {
-        if (m_pipes.at(i).m_col < 5)
-        {
-            pipesToErase.push_back(i);
-        }
+        this->updatePractice(deltaTime);
+
+        return true;
     }
 
-    for (const size_t i : pipesToErase)
+    if (!m_replayPath.empty())
     {
-        // Erase this one
-        m_pipes.erase(m_pipes.begin() + i);
-
-        // Choose random gap size:  [5, 10]
-        const int randomGapSize = rand() % (10 - 5 + 1) + 5;
+        m_replay.record(deltaTime, m_jump);
+    }
 
-        // Choose random gap start: [2, 18]
-        const int randomGapStart = rand() % (18 - 2 + 1) + 2;
+    Simulation::step(m_state, m_parameters, m_jump, deltaTime);
 
-        // Append a new one
-        Pipe newPipe;
-        newPipe.m_velocity = m_pipeVelocity;
-        newPipe.m_colPosition = m_pipes.back().m_col + newPipe.m_width + 15;
-        newPipe.m_col = static_cast<int>(std::round(newPipe.m_colPosition));
-        newPipe.m_gapSize = randomGapSize;
-        newPipe.m_gapStartRow = randomGapStart;
-        m_pipes.emplace_back(std::move(newPipe));
+    if (!m_state.m_running)
+    {
+        m_running = false;
     }
 
     return true;
@@ -90,34 +247,36 @@ bool FlappyBird::update(const double deltaTime)
 //
 bool FlappyBird::render(void)
 {
-    // Draw Pipes to buffer
-    for (const auto& pipe : m_pipes)
-    {
-        bool isHit = false;
-        pipe.drawToOutputBuffer(m_outputBuffer, m_row, m_col, isHit);
+    TRACE_SCOPE("FlappyBird::render");
 
-        if (isHit)
-        {
-            m_running = false;
-        }
+    if (this->usesBandedCompositor())
+    {
+        return this->presentVirtualTerminal(m_compositor->compose(m_state, m_parameters, m_fps));
     }
 
-    // Draw Bird to buffer
-    CHAR_INFO bird;
-    bird.Attributes = 7;
-    bird.Char.UnicodeChar = 0x2588;
+    if (m_canvas != nullptr)
+    {
+        Scene::composeHighResolution(m_state, m_parameters, m_fps, *m_canvas, m_outputBuffer);
+    }
+    else
+    {
+        m_field.compose(m_state, m_parameters, m_fps, m_outputBuffer);
+    }
 
-    int offset = ( m_row * this->width() ) + m_col;
+    if (m_occupancy != nullptr)
+    {
+        this->drawSensors();
+    }
 
-    if (offset >= 0 && offset < m_outputBuffer.size())
+    if (m_versus != nullptr)
     {
-        m_outputBuffer.at(offset) = bird;
+        this->drawVersus();
     }
 
-    // Overlay these last
-    this->drawFPSToOutputBuffer();
-    this->drawVelocityToOutputBuffer();
-    this->drawScoreToOutputBuffer();
+    if (m_history != nullptr)
+    {
+        this->drawPractice();
+    }
 
     return this->ConsoleEngine::render();
 }
@@ -127,31 +286,35 @@ bool FlappyBird::render(void)
 //
 void FlappyBird::resetGameState(void)
 {
-    m_score = 0;
-    m_verticalVelocity = 0.0;
-    m_row = this->height() / 2;
-    m_rowDouble = static_cast<double>(m_row);
-    m_col = 25;
-    m_jump = false;
-    m_running = true;
+    // Before the reset below draws from the RNG, so both sides start alike
+    if (m_versus != nullptr)
+    {
+        m_versus->start(m_parameters, m_state.m_random);
+    }
 
-    m_pipes.clear();
-    m_pipes.reserve(5);
-    for (size_t i = 0; i < 8; ++i)
+    Simulation::reset(m_state, m_parameters);
+
+    // The landing page or the last game over panel is still on screen
+    if (m_compositor != nullptr)
     {
-        // Choose random gap size:  [5, 10]
-        const int randomGapSize = rand() % (10 - 5 + 1) + 5;
+        m_compositor->invalidate();
+    }
 
-        // Choose random gap start: [2, 18]
-        const int randomGapStart = rand() % (18 - 2 + 1) + 2;
+    if (m_history != nullptr)
+    {
+        m_history->clear();
+    }
 
-        Pipe newPipe;
-        newPipe.m_velocity = m_pipeVelocity;
-        newPipe.m_colPosition = (this->width() / 2) + (i * (newPipe.m_width + 15));
-        newPipe.m_col = static_cast<int>(std::round(newPipe.m_colPosition));
-        newPipe.m_gapSize = randomGapSize;
-        newPipe.m_gapStartRow = randomGapStart;
-        m_pipes.emplace_back(std::move(newPipe));
+    m_jump = false;
+    m_autopilotTime = 0.0;
+    m_rewinding = false;
+    m_practiceJump = false;
+    m_practiceTime = 0.0;
+    m_running = true;
+
+    if (!m_replayPath.empty())
+    {
+        m_replay.begin(m_state, m_parameters);
     }
 }
 
@@ -159,6 +322,46 @@ void FlappyBird::resetGameState(void)
 // On Game Begin
 //
 void FlappyBird::onGameBegin(void)
+{
+    // Time spent typing answers would count towards the startup time
+    if (m_promptForParameters && !this->measuringStartup())
+    {
+        this->promptForParameters();
+    }
+
+    // Landing page.
+    const std::wstring welcomeMessage   = L"Welcome to Flappy Bird!";
+    const std::wstring instructions     = L"Press the spacebar to jump.";
+    const std::wstring quitInstructions = L"Press 'q' or 'ESC' to quit.";
+    const std::wstring playInstructions = L"Press any of the above keys to play.";
+    const std::wstring credits          = L"Developed by Tristan Rachman :)";
+    const int row = std::min(11, this->height() - 7);
+    const int col = std::min(40, this->width() - static_cast<int>(playInstructions.length()));
+    this->drawStringToBuffer(welcomeMessage, row, col);
+    this->drawStringToBuffer(instructions, row + 1, col);
+    this->drawStringToBuffer(quitInstructions, row + 2, col);
+    this->drawStringToBuffer(playInstructions, row + 3, col);
+    this->drawStringToBuffer(credits, row + 6, col);
+
+    // Nothing moves here, so draw once and sleep until a key arrives
+    if (!this->ConsoleEngine::render() || this->measuringStartup())
+    {
+        return;
+    }
+
+    while (this->waitForInput(INFINITE))
+    {
+        if (!m_inputCommands.empty())
+        {
+            break;
+        }
+    }
+}
+
+
+// Prompt For Parameters
+//
+void FlappyBird::promptForParameters(void)
 {
     auto isNumber = [](const std::string& str) -> bool
     {
@@ -175,11 +378,11 @@ void FlappyBird::onGameBegin(void)
 
     if (!isNumber(jumpVelocity))
     {
-        m_jumpVelocity = 15.0;
+        m_parameters.m_jumpVelocity = 15.0;
     }
     else
     {
-        m_jumpVelocity = std::stod(jumpVelocity);
+        m_parameters.m_jumpVelocity = std::stod(jumpVelocity);
     }
 
     std::string pipeVelocity;
@@ -188,11 +391,11 @@ void FlappyBird::onGameBegin(void)
 
     if (!isNumber(pipeVelocity))
     {
-        m_pipeVelocity = 15.0;
+        m_parameters.m_pipeVelocity = 15.0;
     }
     else
     {
-        m_pipeVelocity = std::stod(pipeVelocity);
+        m_parameters.m_pipeVelocity = std::stod(pipeVelocity);
     }
 
     std::string gravity;
@@ -201,214 +404,357 @@ void FlappyBird::onGameBegin(void)
 
     if (!isNumber(gravity))
     {
-        m_gravity = 40.0;
+        m_parameters.m_gravity = 40.0;
     }
     else
     {
-        m_gravity = std::stod(gravity);
+        m_parameters.m_gravity = std::stod(gravity);
     }
+}
 
-    // Landing page.
-    const std::wstring welcomeMessage   = L"Welcome to Flappy Bird!";
-    const std::wstring instructions     = L"Press the spacebar to jump.";
-    const std::wstring quitInstructions = L"Press 'q' or 'ESC' to quit.";
-    const std::wstring playInstructions = L"Press any of the above keys to play.";
-    const std::wstring credits          = L"Developed by Tristan Rachman :)";
-    this->drawStringToBuffer(welcomeMessage, 11, 40);
-    this->drawStringToBuffer(instructions, 12, 40);
-    this->drawStringToBuffer(quitInstructions, 13, 40);
-    this->drawStringToBuffer(playInstructions, 14, 40);
-    this->drawStringToBuffer(credits, 17, 40);
 
-    while (true)
+// On Game End
+//
+ConsoleEngine::PlayAgain FlappyBird::onGameEnd(void)
+{
+    // Give the peer our last inputs so it can finish the round too
+    if (m_versus != nullptr)
     {
-        if (!this->input())
-        {
-            break;
-        }
+        m_versus->linger(2.0);
+    }
 
-        if (!this->ConsoleEngine::render())
-        {
-            break;
-        }
+    if (!m_replayPath.empty() && !m_replay.save(m_replayPath))
+    {
+        std::cout << "Unable to save the replay." << std::endl;
+    }
 
-        if (!m_inputCommands.empty())
+    if (m_leaderboard != nullptr && m_history == nullptr)
+    {
+        const uint32_t score = static_cast<uint32_t>(std::min<size_t>(m_state.m_score, UINT32_MAX));
+        m_leaderboard->submit(score, GetCurrentProcessId());
+    }
+
+    // The last frame never reached the cell buffer, which still holds the
+    // landing page or the previous game, so redraw all of it there before
+    // drawing the panel over it
+    if (this->usesBandedCompositor())
+    {
+        m_field.compose(m_state, m_parameters, m_fps, m_outputBuffer);
+    }
+
+    this->drawGameOver();
+
+    if (!this->ConsoleEngine::render())
+    {
+        return PlayAgain::NO;
+    }
+
+    // Keys still held from the game (the spacebar) are ignored here. A
+    // versus round cannot be replayed without the peer, so any answer ends it.
+    while (this->waitForInput(INFINITE))
+    {
+        for (const Input input : m_inputCommands)
         {
-            break;
+            if (input == Input::YES && m_versus == nullptr)
+            {
+                return PlayAgain::YES;
+            }
+            else if (input == Input::YES || input == Input::NO || input == Input::QUIT)
+            {
+                return PlayAgain::NO;
+            }
         }
     }
+
+    return PlayAgain::NO;
 }
 
 
-// On Game End
+// Uses Banded Compositor
+// Only the plain cell view goes through it; the other views draw over the
+// cell buffer.
 //
-ConsoleEngine::PlayAgain FlappyBird::onGameEnd(void) const
+bool FlappyBird::usesBandedCompositor(void) const
 {
-    std::wstring scoreString = L"Your score was: " + std::to_wstring(m_score)
-                             + L"\nYou wanna play again?";
-
-    constexpr int YES_INT = 6;
-    const int response = MessageBox(
-        nullptr,
-        scoreString.data(),
-        TEXT("Uh oh!"),
-        MB_YESNO);
+    const bool overlays = (m_versus != nullptr || m_history != nullptr || m_occupancy != nullptr);
 
-    return response == YES_INT ? PlayAgain::YES : PlayAgain::NO;
+    return m_compositor != nullptr && m_canvas == nullptr && !overlays;
 }
 
 
-// Update Physics
-// 
-void FlappyBird::updatePhysics(const double deltaTime)
+// Draw Game Over
+// A panel in the middle of the field with the score and the leaderboard.
+//
+void FlappyBird::drawGameOver(void)
 {
-    if (m_jump)
+    std::vector<std::wstring> lines;
+    lines.push_back(L"Uh oh!");
+    lines.push_back(L"");
+    lines.push_back(L"Your score was: " + std::to_wstring(m_state.m_score));
+
+    if (m_versus != nullptr)
     {
-        m_verticalVelocity = m_jumpVelocity;
+        const size_t rivalScore = m_versus->rival().m_score;
+        lines.push_back(L"Your rival's was: " + std::to_wstring(rivalScore));
+
+        if (m_state.m_score > rivalScore)
+        {
+            lines.push_back(L"You win!");
+        }
+        else if (m_state.m_score < rivalScore)
+        {
+            lines.push_back(L"You lose!");
+        }
+        else
+        {
+            lines.push_back(L"It's a draw!");
+        }
     }
 
-    m_verticalVelocity = m_verticalVelocity - (m_gravity * deltaTime);
+    if (m_leaderboard != nullptr)
+    {
+        lines.push_back(L"");
+        lines.push_back(L"Leaderboard:");
+        int rank = 1;
 
-    m_rowDouble -= (m_verticalVelocity * deltaTime);
+        for (const LeaderboardEntry& entry : m_leaderboard->snapshot())
+        {
+            lines.push_back(std::to_wstring(rank++) + L". " + std::to_wstring(entry.m_score)
+                          + L"  (process " + std::to_wstring(entry.m_processId) + L")");
+        }
+    }
 
-    m_row = static_cast<int>(std::round(m_rowDouble));
-}
+    lines.push_back(L"");
+    lines.push_back(m_versus == nullptr ? L"You wanna play again? (y/n)" : L"Press 'n' or 'q' to leave.");
 
+    size_t longest = 0;
 
-// Handle Input Events
-//
-void FlappyBird::handleInputEvents(void)
-{
-    m_jump = false;
+    for (const std::wstring& line : lines)
+    {
+        longest = std::max(longest, line.length());
+    }
 
-    for (const Input input : m_inputCommands)
+    // One cell of padding and a border on every side
+    const int panelWidth = std::min(static_cast<int>(longest) + 4, this->width());
+    const int panelHeight = std::min(static_cast<int>(lines.size()) + 4, this->height());
+    const int top = (this->height() - panelHeight) / 2;
+    const int left = (this->width() - panelWidth) / 2;
+
+    for (int row = 0; row < panelHeight; ++row)
     {
-        if (input == Input::QUIT || input == Input::UNDEFINED)
+        std::wstring text(panelWidth, L' ');
+        const bool edgeRow = (row == 0 || row == panelHeight - 1);
+
+        for (int col = 0; col < panelWidth; ++col)
         {
-            // Break out of the game loop
-            m_running = false;
-            break;
+            const bool edgeCol = (col == 0 || col == panelWidth - 1);
+
+            if (edgeRow && edgeCol)
+            {
+                text[col] = L'+';
+            }
+            else if (edgeRow)
+            {
+                text[col] = L'-';
+            }
+            else if (edgeCol)
+            {
+                text[col] = L'|';
+            }
         }
-        else if (input == Input::JUMP)
+
+        const int line = row - 2;
+
+        if (line >= 0 && line < static_cast<int>(lines.size()))
         {
-            m_jump = true;
-            break;
+            const std::wstring& content = lines[line];
+            const size_t room = static_cast<size_t>(std::max(panelWidth - 4, 0));
+            text.replace(2, std::min(content.length(), room), content, 0, room);
         }
+
+        this->drawStringToBuffer(text, top + row, left);
     }
 }
 
 
-// Draw FPS to Screen
+// Draw Versus
+// Under the score in the corner: the rival's score and whatever the match
+// is waiting on.
 //
-void FlappyBird::drawFPSToOutputBuffer(void)
+void FlappyBird::drawVersus(void)
 {
-    const int fpsInt = static_cast<int>(std::ceil(m_fps));
-    const std::wstring fpsStr = L"FPS: " + std::to_wstring(fpsInt);
+    const GameState& rival = m_versus->rival();
 
-    this->drawStringToBuffer(fpsStr, 0, 0);
+    // Ours stays on top when they share a cell
+    if (rival.m_row != m_state.m_row)
+    {
+        Scene::drawRival(rival, m_parameters, m_outputBuffer);
+    }
+
+    this->drawStringToBuffer(L"Rival: " + std::to_wstring(rival.m_score), 3, 0);
+
+    if (m_versus->waiting())
+    {
+        this->drawStringToBuffer(L"Waiting for rival...", 4, 0);
+    }
+    else if (!m_state.m_running)
+    {
+        this->drawStringToBuffer(L"You're out, watching rival", 4, 0);
+    }
 }
 
 
-// Draw Score to Screen
+// Draw Sensors
+// The map is built from the state about to be shown, once per frame,
+// whichever of the update paths produced it.
 //
-void FlappyBird::drawScoreToOutputBuffer(void)
+void FlappyBird::drawSensors(void)
 {
-    const std::wstring scoreStr = L"Score: " + std::to_wstring(m_score);
+    m_occupancy->build(m_state);
+    m_occupancy->castRays(m_state.m_row, m_state.m_col, m_rays, m_rayDistances.data());
 
-    this->drawStringToBuffer(scoreStr, 2, 0);
-}
+    CHAR_INFO trail;
+    trail.Attributes = FOREGROUND_INTENSITY;
+    trail.Char.UnicodeChar = 0x00B7;
 
+    CHAR_INFO end;
+    end.Attributes = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY;
+    end.Char.UnicodeChar = L'*';
 
-// Draw Velocity to Screen
-//
-void FlappyBird::drawVelocityToOutputBuffer(void)
-{
-    const std::wstring velStr = L"Velocity: " + std::to_wstring(m_verticalVelocity);
+    for (size_t i = 0; i < m_rays.size(); ++i)
+    {
+        const OccupancyMap::Direction& direction = m_rays[i].m_direction;
 
-    this->drawStringToBuffer(velStr, 1, 0);
+        // A dot a cell apart, not counting the bird's own cell
+        for (double t = 1.0; t <= m_rayDistances[i]; t += 1.0)
+        {
+            const bool last = (t + 1.0 > m_rayDistances[i]);
+            const int row = static_cast<int>(std::floor(m_state.m_row + 0.5 + (direction.m_row * t)));
+            const int col = static_cast<int>(std::floor(m_state.m_col + 0.5 + (direction.m_col * t)));
+
+            if (row >= 0 && row < this->height() && col >= 0 && col < this->width() && !m_occupancy->occupied(row, col))
+            {
+                m_outputBuffer[(static_cast<size_t>(row) * this->width()) + col] = last ? end : trail;
+            }
+        }
+    }
 }
 
 
-// Update Pipe position
+// Draw Practice
+// Under the score in the corner: how far back rewinding can go.
 //
-void Pipe::updatePosition(const double deltaTime)
+void FlappyBird::drawPractice(void)
 {
-    m_colPosition -= (m_velocity * deltaTime);
-    m_col = static_cast<int>(std::round(m_colPosition));
+    const int tenths = static_cast<int>(m_history->secondsAvailable() * 10.0);
+    const std::wstring seconds = std::to_wstring(tenths / 10) + L"." + std::to_wstring(tenths % 10) + L"s";
+
+    if (m_rewinding)
+    {
+        this->drawStringToBuffer(L"<< REWIND  " + seconds + L" left", 3, 0);
+    }
+    else
+    {
+        this->drawStringToBuffer(L"History: " + seconds, 3, 0);
+    }
+
+    if (!m_state.m_running)
+    {
+        this->drawStringToBuffer(L"Hold 'r' to rewind, 'q' to quit", 4, 0);
+    }
 }
 
 
-// Draw pipe to output buffer
+// Update Practice
+// Whole ticks only, so the history replays exactly. While the bird is
+// dead nothing moves until it is rewound.
 //
-void Pipe::drawToOutputBuffer(
-    std::vector<CHAR_INFO>& outputBuffer,
-    const int birdRow,
-    const int birdCol,
-    bool& isHit) const
+void FlappyBird::updatePractice(const double deltaTime)
 {
-    constexpr double WIDTH = 120;
-    constexpr double HEIGHT = 30;
+    // A long stall is not worth catching up on
+    constexpr double maximumCatchUp = 0.25;
+    const double tickSeconds = m_history->tickSeconds();
 
-    if (m_col < 0 || m_col >= WIDTH - m_width)
-    {
-        return; // Do not draw this
-    }
+    m_practiceJump = m_practiceJump || m_jump;
+    m_practiceTime = std::min(m_practiceTime + deltaTime, maximumCatchUp);
 
-    // Draw the pipe
-    //
-    for (int row = 0; row < m_gapStartRow; ++row)
+    for (; m_practiceTime >= tickSeconds; m_practiceTime -= tickSeconds)
     {
-        for (int col = m_col; col < m_col + m_width; ++col)
+        if (m_rewinding)
         {
-            CHAR_INFO charInfo;
-            charInfo.Attributes = FOREGROUND_GREEN;
-            charInfo.Char.UnicodeChar = 0x2588;
-
-            const int offset = Utilities::computeTheOffset(row, col, WIDTH);
-
-            if (birdRow == row && birdCol == col)
+            if (!m_history->stepBack(m_state, m_parameters) || !m_history->stepBack(m_state, m_parameters))
             {
-                isHit = true;
+                break;
             }
+        }
+        else if (m_state.m_running)
+        {
+            m_history->record(m_state, m_practiceJump);
+            Simulation::step(m_state, m_parameters, m_practiceJump, tickSeconds);
+            m_practiceJump = false;
+        }
+    }
+
+    // Jumps made while dead or rewinding are not saved up
+    if (m_rewinding || !m_state.m_running)
+    {
+        m_practiceJump = false;
+    }
+}
 
-            if (row == m_gapStartRow - 1 && col == m_col)
-            {
-                outputBuffer.at(offset - 1) = charInfo;
-            }
-            else if (row == m_gapStartRow - 1 && col == m_col + m_width - 1)
-            {
-                outputBuffer.at(offset + 1) = charInfo;
-            }
 
-            outputBuffer.at(offset) = charInfo;
+// Handle Input Events
+//
+void FlappyBird::handleInputEvents(void)
+{
+    m_jump = false;
+
+    // Every event is looked at, so a rewind key is not lost behind a jump
+    for (const Input input : m_inputCommands)
+    {
+        if (input == Input::QUIT || input == Input::UNDEFINED)
+        {
+            // Break out of the game loop
+            m_running = false;
+            break;
+        }
+        else if (input == Input::JUMP)
+        {
+            m_jump = true;
+        }
+        else if (input == Input::REWIND)
+        {
+            m_rewinding = true;
+        }
+        else if (input == Input::REWIND_END)
+        {
+            m_rewinding = false;
         }
     }
+}
 
-    for (int row = m_gapStartRow + m_gapSize; row < HEIGHT; ++row)
+
+// Handle Autopilot
+// The bot plans on a fixed tick, so it is only consulted once per tick.
+//
+void FlappyBird::handleAutopilot(const double deltaTime)
+{
+    if (!m_autopilot)
     {
-        for (int col = m_col; col < m_col + m_width; ++col)
-        {
-            CHAR_INFO charInfo;
-            charInfo.Attributes = FOREGROUND_GREEN;
-            charInfo.Char.UnicodeChar = 0x2588;
+        return;
+    }
 
-            const int offset = Utilities::computeTheOffset(row, col, WIDTH);
+    m_autopilotTime += deltaTime;
 
-            if (birdRow == row && birdCol == col)
-            {
-                isHit = true;
-            }
+    if (m_autopilotTime < m_autopilot->tickSeconds())
+    {
+        return;
+    }
 
-            if (row == m_gapStartRow + m_gapSize && col == m_col)
-            {
-                outputBuffer.at(offset - 1) = charInfo;
-            }
-            else if (row == m_gapStartRow + m_gapSize && col == m_col + m_width - 1)
-            {
-                outputBuffer.at(offset + 1) = charInfo;
-            }
+    m_autopilotTime = std::fmod(m_autopilotTime, m_autopilot->tickSeconds());
 
-            outputBuffer.at(offset) = charInfo;
-        }
+    if (m_autopilot->decide(m_state, m_parameters))
+    {
+        m_jump = true;
     }
 }
@@ -1,6 +1,21 @@
 #pragma once
 
+#include "Autopilot.h"
+#include "BandedCompositor.h"
 #include "ConsoleEngine.hpp"
+#include "Leaderboard.h"
+#include "Level.h"
+#include "Netplay.h"
+#include "OccupancyMap.h"
+#include "PixelCanvas.h"
+#include "Replay.h"
+#include "RewindHistory.h"
+#include "ScrollingField.h"
+#include "Simulation.h"
+
+#include <memory>
+#include <string>
+#include <vector>
 
 
 struct Point
@@ -10,27 +25,6 @@ struct Point
 };
 
 
-struct Pipe
-{
-    static constexpr int m_width = 4;
-    double m_velocity = 15.0; // units per second
-
-    double m_colPosition = 0.0;
-
-    int m_col = 0;         // Will decrement from the end each second
-    int m_gapSize = 10;    // How big the gap is
-    int m_gapStartRow = 7; // The row the gap starts relative to the top
-    bool m_scoreTracked = false;
-
-    void updatePosition(const double deltaTime);
-    void drawToOutputBuffer(
-        std::vector<CHAR_INFO>& outputBuffer,
-        const int birdRow,
-        const int birtCol,
-        bool& isHit) const;
-};
-
-
 class FlappyBird : public ConsoleEngine
 {
 public:
@@ -50,6 +44,62 @@ public:
     //
     virtual ~FlappyBird(void) = default;
 
+    // Snapshot
+    // The whole game state is one trivially copyable block, so save and
+    // restore are a single memcpy each.
+    //
+    [[nodiscard]] GameState save(void) const;
+    void restore(const GameState& state);
+
+    // Supplied parameters replace the interactive prompts
+    //
+    void setParameters(const GameParameters& parameters);
+    void setSeed(const uint64_t seed);
+
+    // Let the beam-search bot play
+    //
+    void enableAutopilot(void);
+
+    // Record each game to a replay file for the offline renderer
+    //
+    void enableRecording(const std::string& path);
+
+    // Draw at sub-cell resolution with half block or Braille glyphs
+    //
+    void enableHighResolution(const PixelCanvas::Mode mode);
+
+    // Compose and encode the cell view in row bands on a pool of threads
+    // and send it as escape sequences, for very large terminals. The high
+    // resolution, versus, practice and sensor views still draw the usual
+    // way.
+    //
+    void enableBandedCompositor(const int threadCount);
+
+    // Race another game over UDP on the same course. Fails if the local
+    // port cannot be bound.
+    //
+    [[nodiscard]] bool enableVersus(const VersusOptions& options);
+
+    // Practice: play on a fixed tick, keep the last minute, and let 'r'
+    // rewind it. Dying pauses rather than ending the game. Nothing is
+    // submitted to the leaderboard or recorded.
+    //
+    void enablePractice(void);
+
+    // Cast a fan of rays from the bird every frame and draw them, to see
+    // what a bot could sense
+    //
+    void enableSensors(const int rayCount);
+
+    // Play an authored course instead of random pipes. The level must stay
+    // open for as long as the game runs.
+    //
+    void enableLevel(Level& level);
+
+    // Submit each final score to a leaderboard file shared between processes
+    //
+    void enableLeaderboard(const std::string& path);
+
 private:
     // Virtual Methods
     //
@@ -57,40 +107,68 @@ private:
     [[nodiscard]] bool render(void) override;
     void resetGameState(void) override;
     void onGameBegin(void) override;
-    [[nodiscard]] PlayAgain onGameEnd(void) const override;
+    [[nodiscard]] PlayAgain onGameEnd(void) override;
 
-    // Update Physics
-    // 
-    void updatePhysics(const double deltaTime);
+    // Ask for jump velocity, pipe velocity and gravity
+    //
+    void promptForParameters(void);
 
-    // Handle Input Events
-    // 
-    void handleInputEvents(void);
+    // Whether frames go straight to the terminal from the banded
+    // compositor, leaving the cell buffer unused
+    //
+    [[nodiscard]] bool usesBandedCompositor(void) const;
 
-    // Draw FPS to Screen
+    // Draw the game over panel over the last frame
     //
-    void drawFPSToOutputBuffer(void);
+    void drawGameOver(void);
 
-    // Draw Score to Screen
+    // Rival bird and versus status over the scene
     //
-    void drawScoreToOutputBuffer(void);
+    void drawVersus(void);
+
+    // Rewind history and status over the scene
+    //
+    void drawPractice(void);
+
+    // Sensor rays over the scene, each up to what it hit
+    //
+    void drawSensors(void);
+
+    // Play or rewind whole ticks of practice
+    //
+    void updatePractice(const double deltaTime);
+
+    // Handle Input Events
+    // 
+    void handleInputEvents(void);
 
-    // Draw Velocity to Screen
+    // Ask the bot whether to jump
     //
-    void drawVelocityToOutputBuffer(void);
+    void handleAutopilot(const double deltaTime);
 
     // Private Data Variables
     //
-    size_t m_score;
-    double m_verticalVelocity;
-    double m_rowDouble;
+    GameState m_state;
     bool m_jump;
-    int m_row;
-    int m_col;
-    std::vector<Pipe> m_pipes;
+    std::unique_ptr<Autopilot> m_autopilot;
+    double m_autopilotTime;
+    Replay m_replay;
+    std::string m_replayPath;
+    std::unique_ptr<Leaderboard> m_leaderboard;
+    ScrollingField m_field;
+    std::unique_ptr<PixelCanvas> m_canvas;
+    std::unique_ptr<VersusMatch> m_versus;
+    std::unique_ptr<BandedCompositor> m_compositor;
+    std::unique_ptr<RewindHistory> m_history;
+    std::unique_ptr<OccupancyMap> m_occupancy;
+    std::vector<OccupancyMap::Ray> m_rays;
+    std::vector<double> m_rayDistances;
+    Level* m_level;
+    bool m_rewinding;
+    bool m_practiceJump;  // Pressed since the last practice tick
+    double m_practiceTime;
 
     // Configurable parameters
-    double m_jumpVelocity;
-    double m_pipeVelocity;
-    double m_gravity;
+    GameParameters m_parameters;
+    bool m_promptForParameters;
 };
@@ -0,0 +1,192 @@
+#include "GameGrid.h"
+#include "Scene.h"
+#include "Trace.h"
+
+#include <algorithm>
+
+
+namespace
+{
+    // A lighter search than the single-game autopilot, so dozens of games
+    // fit in a frame
+    constexpr int BOT_BEAM_WIDTH = 8;
+    constexpr int BOT_DEPTH = 8;
+    constexpr int BOT_TICKS_PER_PLY = 4;
+
+    constexpr double TICK_SECONDS = 1.0 / 60.0;
+
+    // Long enough to see which tile died
+    constexpr double RESTART_SECONDS = 1.0;
+
+    // A stalled frame is not caught up on beyond this
+    constexpr int MAX_TICKS_PER_FRAME = 4;
+
+    // The top row is left for the viewer's status line
+    constexpr int FIRST_TILE_ROW = 1;
+}
+
+
+// Constructor
+//
+GameGrid::GameGrid(
+    const GameParameters& parameters,
+    const int columns,
+    const int rows,
+    const int frameWidth,
+    const int frameHeight,
+    const uint64_t firstSeed,
+    const int threadCount)
+: m_parameters(parameters),
+  m_columns(std::max(columns, 1)),
+  m_rows(std::max(rows, 1)),
+  m_frameWidth(frameWidth),
+  m_tileWidth(0),
+  m_tileHeight(0),
+  m_firstSeed(firstSeed),
+  m_tickSeconds(TICK_SECONDS),
+  m_pendingSeconds(0.0),
+  m_games(),
+  m_pool(threadCount)
+{
+    m_tileWidth = frameWidth / m_columns;
+    m_tileHeight = std::max(frameHeight - FIRST_TILE_ROW, 0) / m_rows;
+
+    m_games.resize(static_cast<size_t>(m_columns) * m_rows);
+
+    for (size_t i = 0; i < m_games.size(); ++i)
+    {
+        m_games[i].m_bot = std::make_unique<Autopilot>(BOT_BEAM_WIDTH, BOT_DEPTH, BOT_TICKS_PER_PLY, m_tickSeconds);
+        this->startGame(m_games[i], static_cast<int>(i));
+    }
+}
+
+
+// Update
+//
+void GameGrid::update(const double deltaTime, std::vector<CHAR_INFO>& frame)
+{
+    TRACE_SCOPE("GameGrid::update");
+
+    m_pendingSeconds = std::min(m_pendingSeconds + deltaTime, MAX_TICKS_PER_FRAME * m_tickSeconds);
+    const int ticks = static_cast<int>(m_pendingSeconds / m_tickSeconds);
+    m_pendingSeconds -= ticks * m_tickSeconds;
+
+    m_pool.run(this->gameCount(), [&](const int index)
+    {
+        Game& game = m_games[index];
+        this->advanceGame(game, index, ticks);
+        this->drawTile(game, index, frame);
+    });
+}
+
+
+// Game Count
+//
+int GameGrid::gameCount(void) const
+{
+    return static_cast<int>(m_games.size());
+}
+
+
+// Thread Count
+//
+int GameGrid::threadCount(void) const
+{
+    return m_pool.threadCount();
+}
+
+
+// Games Played
+//
+uint64_t GameGrid::gamesPlayed(void) const
+{
+    uint64_t played = 0;
+
+    for (const Game& game : m_games)
+    {
+        played += game.m_runs - (game.m_state.m_running ? 1 : 0);
+    }
+
+    return played;
+}
+
+
+// Best Score
+//
+size_t GameGrid::bestScore(void) const
+{
+    size_t best = 0;
+
+    for (const Game& game : m_games)
+    {
+        best = std::max(best, game.m_bestScore);
+    }
+
+    return best;
+}
+
+
+// Start Game
+// Course n of tile i is seeded from its own slot, so a run of the grid
+// is the same whatever the thread count.
+//
+void GameGrid::startGame(Game& game, const int index) const
+{
+    game.m_state = GameState();
+    game.m_state.m_random.seed(m_firstSeed + index + (static_cast<uint64_t>(game.m_runs) * m_games.size()));
+    Simulation::reset(game.m_state, m_parameters);
+    game.m_restartSeconds = RESTART_SECONDS;
+    ++game.m_runs;
+}
+
+
+// Advance Game
+//
+void GameGrid::advanceGame(Game& game, const int index, const int ticks) const
+{
+    for (int tick = 0; tick < ticks; ++tick)
+    {
+        if (game.m_state.m_running)
+        {
+            const bool jump = game.m_bot->decide(game.m_state, m_parameters);
+            Simulation::step(game.m_state, m_parameters, jump, m_tickSeconds);
+            game.m_bestScore = std::max(game.m_bestScore, game.m_state.m_score);
+        }
+        else if ((game.m_restartSeconds -= m_tickSeconds) <= 0.0)
+        {
+            this->startGame(game, index);
+        }
+    }
+}
+
+
+// Draw Tile
+// The game inside, a separator down the right and along the bottom.
+//
+void GameGrid::drawTile(const Game& game, const int index, std::vector<CHAR_INFO>& frame) const
+{
+    if (m_tileWidth < 2 || m_tileHeight < 2)
+    {
+        return;
+    }
+
+    const int left = (index % m_columns) * m_tileWidth;
+    const int top = FIRST_TILE_ROW + ((index / m_columns) * m_tileHeight);
+
+    Scene::composeTile(game.m_state, m_parameters, frame.data(), m_frameWidth, left, top, m_tileWidth - 1, m_tileHeight - 1);
+
+    CHAR_INFO separator;
+    separator.Attributes = FOREGROUND_INTENSITY;
+    separator.Char.UnicodeChar = 0x2502;
+
+    for (int row = top; row < top + m_tileHeight - 1; ++row)
+    {
+        frame[(static_cast<size_t>(row) * m_frameWidth) + left + m_tileWidth - 1] = separator;
+    }
+
+    CHAR_INFO* bottom = frame.data() + (static_cast<size_t>(top + m_tileHeight - 1) * m_frameWidth) + left;
+    separator.Char.UnicodeChar = 0x2500;
+    std::fill(bottom, bottom + m_tileWidth - 1, separator);
+    separator.Char.UnicodeChar = 0x253C;
+    bottom[m_tileWidth - 1] = separator;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Autopilot.h"
+#include "ConsoleEngine.hpp"
+#include "Simulation.h"
+#include "WorkerPool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+// GameGrid
+// Many independent bot-played games shown side by side, one tile each, in
+// a single frame. Every game plays on the same fixed tick; a dead game
+// stays on screen for a moment and then starts again on a new course.
+// Each frame is one task per game on a persistent worker pool: play the
+// ticks that are due, then draw into that game's own rectangle of the
+// frame, so nothing is shared between tasks. Needs no console, so the
+// viewer and the benchmark drive it the same way.
+//
+class GameGrid
+{
+public:
+    // Deleted Special Member Functions
+    //
+    GameGrid(void) = delete;
+    GameGrid(const GameGrid& RHS) = delete;
+    GameGrid(GameGrid&& RHS) = delete;
+    GameGrid& operator=(const GameGrid& RHS) = delete;
+    GameGrid& operator=(GameGrid&& RHS) = delete;
+
+    // Constructor
+    // columns x rows games played with the given parameters, tiled below
+    // the top row of a frameWidth x frameHeight frame.
+    //
+    GameGrid(
+        const GameParameters& parameters,
+        const int columns,
+        const int rows,
+        const int frameWidth,
+        const int frameHeight,
+        const uint64_t firstSeed,
+        const int threadCount);
+
+    // Destructor
+    //
+    ~GameGrid(void) = default;
+
+    // Update
+    // Plays every game on by deltaTime and draws each into its tile.
+    //
+    void update(const double deltaTime, std::vector<CHAR_INFO>& frame);
+
+    [[nodiscard]] int gameCount(void) const;
+    [[nodiscard]] int threadCount(void) const;
+    [[nodiscard]] uint64_t gamesPlayed(void) const;  // Finished, over all tiles
+    [[nodiscard]] size_t bestScore(void) const;
+
+private:
+    struct alignas(64) Game
+    {
+        GameState m_state;
+        std::unique_ptr<Autopilot> m_bot;
+        double m_restartSeconds = 0.0; // Left before a dead game starts again
+        uint32_t m_runs = 0;           // Courses started
+        size_t m_bestScore = 0;
+    };
+
+    void startGame(Game& game, const int index) const;
+    void advanceGame(Game& game, const int index, const int ticks) const;
+    void drawTile(const Game& game, const int index, std::vector<CHAR_INFO>& frame) const;
+
+    // Private Data Variables
+    //
+    GameParameters m_parameters;
+    int m_columns;
+    int m_rows;
+    int m_frameWidth;
+    int m_tileWidth;   // Separator column included
+    int m_tileHeight;  // Separator row included
+    uint64_t m_firstSeed;
+    double m_tickSeconds;
+    double m_pendingSeconds;
+    std::vector<Game> m_games;
+    WorkerPool m_pool;
+};
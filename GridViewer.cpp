@@ -0,0 +1,87 @@
+#include "GridViewer.h"
+#include "Trace.h"
+
+#include <cmath>
+
+
+// Constructor
+//
+GridViewer::GridViewer(
+    const std::wstring& title,
+    const int width,
+    const int height,
+    const GameParameters& parameters,
+    const int columns,
+    const int rows,
+    const uint64_t firstSeed,
+    const int threadCount)
+: ConsoleEngine(title, width, height),
+  m_grid(parameters, columns, rows, width, height, firstSeed, threadCount)
+{
+    // Tiles and the status line cover everything that is ever drawn
+    m_clearEachFrame = false;
+}
+
+
+// Update
+//
+bool GridViewer::update(const double deltaTime)
+{
+    TRACE_SCOPE("GridViewer::update");
+
+    for (const Input input : m_inputCommands)
+    {
+        if (input == Input::QUIT || input == Input::UNDEFINED)
+        {
+            m_running = false;
+        }
+    }
+
+    m_grid.update(deltaTime, m_outputBuffer);
+
+    return true;
+}
+
+
+// Render
+//
+bool GridViewer::render(void)
+{
+    TRACE_SCOPE("GridViewer::render");
+
+    std::wstring status = std::to_wstring(m_grid.gameCount()) + L" games on "
+                        + std::to_wstring(m_grid.threadCount()) + L" threads | FPS: "
+                        + std::to_wstring(static_cast<int>(std::ceil(m_fps))) + L" | Finished: "
+                        + std::to_wstring(m_grid.gamesPlayed()) + L" | Best score: "
+                        + std::to_wstring(m_grid.bestScore()) + L" | 'q' to quit";
+
+    status.resize(static_cast<size_t>(this->width()), L' ');
+    this->drawStringToBuffer(status, 0, 0);
+
+    return this->ConsoleEngine::render();
+}
+
+
+// Reset Game State
+// The grid restarts its own games.
+//
+void GridViewer::resetGameState(void)
+{
+    m_running = true;
+}
+
+
+// On Game Begin
+//
+void GridViewer::onGameBegin(void)
+{
+}
+
+
+// On Game End
+// Only reached by quitting.
+//
+ConsoleEngine::PlayAgain GridViewer::onGameEnd(void)
+{
+    return PlayAgain::NO;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "ConsoleEngine.hpp"
+#include "GameGrid.h"
+
+#include <string>
+
+
+// GridViewer
+// Shows a GameGrid in the console: the tiles and a status line, written
+// in one call per frame. 'q' or Escape quits.
+//
+class GridViewer : public ConsoleEngine
+{
+public:
+    // Deleted Special Member Functions
+    //
+    GridViewer(void) = delete;
+    GridViewer(const GridViewer& RHS) = delete;
+    GridViewer(GridViewer&& RHS) = delete;
+    GridViewer& operator=(const GridViewer& RHS) = delete;
+    GridViewer& operator=(GridViewer&& RHS) = delete;
+
+    // Constructor
+    // The games play on a field of the parameters' size, scaled into
+    // tiles of a width x height console.
+    //
+    GridViewer(
+        const std::wstring& title,
+        const int width,
+        const int height,
+        const GameParameters& parameters,
+        const int columns,
+        const int rows,
+        const uint64_t firstSeed,
+        const int threadCount);
+
+    // Destructor
+    //
+    virtual ~GridViewer(void) = default;
+
+private:
+    // Virtual Methods
+    //
+    [[nodiscard]] bool update(const double deltaTime) override;
+    [[nodiscard]] bool render(void) override;
+    void resetGameState(void) override;
+    void onGameBegin(void) override;
+    [[nodiscard]] PlayAgain onGameEnd(void) override;
+
+    // Private Data Variables
+    //
+    GameGrid m_grid;
+};
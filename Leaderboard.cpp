@@ -0,0 +1,224 @@
+#include "Leaderboard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <iterator>
+
+
+namespace
+{
+    // "FBLB", format version 1, capacity
+    constexpr uint64_t LEADERBOARD_FORMAT = 0x424C4246ull
+                                          | (1ull << 32)
+                                          | (static_cast<uint64_t>(Leaderboard::m_capacity) << 48);
+
+    static_assert(std::atomic_ref<uint64_t>::is_always_lock_free);
+
+    uint64_t pack(const uint32_t score, const uint32_t processId)
+    {
+        return (static_cast<uint64_t>(score) << 32) | processId;
+    }
+
+    LeaderboardEntry unpack(const uint64_t slot)
+    {
+        LeaderboardEntry entry;
+        entry.m_score = static_cast<uint32_t>(slot >> 32);
+        entry.m_processId = static_cast<uint32_t>(slot);
+
+        return entry;
+    }
+}
+
+
+// Constructor
+//
+Leaderboard::Leaderboard(void)
+: m_file(INVALID_HANDLE_VALUE),
+  m_mapping(nullptr),
+  m_table(nullptr)
+{
+}
+
+
+// Destructor
+//
+Leaderboard::~Leaderboard(void)
+{
+    this->close();
+}
+
+
+// Open
+//
+bool Leaderboard::open(const std::string& path)
+{
+    this->close();
+
+    m_file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "Unable to open leaderboard file: " << path << std::endl;
+
+        return false;
+    }
+
+    // Mapping past the end grows a new file with zeroes, i.e. empty slots
+    m_mapping = CreateFileMapping(m_file, nullptr, PAGE_READWRITE, 0, sizeof(Table), nullptr);
+
+    if (m_mapping == nullptr)
+    {
+        std::cout << "Unable to map leaderboard file: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    m_table = static_cast<Table*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Table)));
+
+    if (m_table == nullptr)
+    {
+        std::cout << "Unable to map leaderboard file: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    // Whoever gets here first stamps the format; everyone else checks it
+    uint64_t format = 0;
+    std::atomic_ref<uint64_t>(m_table->m_format).compare_exchange_strong(format, LEADERBOARD_FORMAT);
+
+    if (format != 0 && format != LEADERBOARD_FORMAT)
+    {
+        std::cout << "Not a leaderboard file, or a different version: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    return true;
+}
+
+
+// Submit
+// Evicts the lowest slot if the new score beats it. A failed swap means
+// another process changed the table under us, so look again.
+//
+bool Leaderboard::submit(const uint32_t score, const uint32_t processId)
+{
+    if (m_table == nullptr || score == 0)
+    {
+        return false;
+    }
+
+    const uint64_t value = pack(score, processId);
+
+    for (;;)
+    {
+        int lowestIndex = 0;
+        uint64_t lowest = std::atomic_ref<uint64_t>(m_table->m_slots[0]).load();
+
+        for (int i = 1; i < m_capacity; ++i)
+        {
+            const uint64_t slot = std::atomic_ref<uint64_t>(m_table->m_slots[i]).load();
+
+            if (slot < lowest)
+            {
+                lowest = slot;
+                lowestIndex = i;
+            }
+        }
+
+        if (value <= lowest)
+        {
+            return false;
+        }
+
+        if (std::atomic_ref<uint64_t>(m_table->m_slots[lowestIndex]).compare_exchange_strong(lowest, value))
+        {
+            FlushViewOfFile(m_table, sizeof(Table));
+
+            return true;
+        }
+    }
+}
+
+
+// Snapshot
+// Every swap raises a slot, so no slot can change and change back. Two
+// identical copies therefore mean the table held exactly those values at
+// the moment between them.
+//
+std::vector<LeaderboardEntry> Leaderboard::snapshot(void) const
+{
+    std::vector<LeaderboardEntry> entries;
+
+    if (m_table == nullptr)
+    {
+        return entries;
+    }
+
+    uint64_t previous[m_capacity];
+    uint64_t current[m_capacity];
+
+    for (int i = 0; i < m_capacity; ++i)
+    {
+        current[i] = std::atomic_ref<uint64_t>(m_table->m_slots[i]).load();
+    }
+
+    do
+    {
+        std::copy(std::begin(current), std::end(current), std::begin(previous));
+
+        for (int i = 0; i < m_capacity; ++i)
+        {
+            current[i] = std::atomic_ref<uint64_t>(m_table->m_slots[i]).load();
+        }
+    }
+    while (!std::equal(std::begin(current), std::end(current), std::begin(previous)));
+
+    std::sort(std::begin(current), std::end(current), std::greater<uint64_t>());
+
+    for (const uint64_t slot : current)
+    {
+        if (slot != 0)
+        {
+            entries.push_back(unpack(slot));
+        }
+    }
+
+    return entries;
+}
+
+
+// Close
+//
+void Leaderboard::close(void)
+{
+    if (m_table != nullptr)
+    {
+        UnmapViewOfFile(m_table);
+        m_table = nullptr;
+    }
+
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <windows.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+struct LeaderboardEntry
+{
+    uint32_t m_score = 0;
+    uint32_t m_processId = 0;
+};
+
+
+// Leaderboard
+// A top-N table in a memory-mapped file shared by every game process on
+// the host. Each slot is one 64-bit word packing score and process id, and
+// a submission replaces the lowest slot with a single compare-and-swap, so
+// there is no lock to be left held by a process that dies. Slots only ever
+// grow, which lets a reader take a consistent snapshot by copying the
+// table until two copies in a row agree.
+//
+class Leaderboard
+{
+public:
+    static constexpr int m_capacity = 10;
+
+    // Deleted Special Member Functions
+    //
+    Leaderboard(const Leaderboard& RHS) = delete;
+    Leaderboard(Leaderboard&& RHS) = delete;
+    Leaderboard& operator=(const Leaderboard& RHS) = delete;
+    Leaderboard& operator=(Leaderboard&& RHS) = delete;
+
+    // Constructor
+    //
+    Leaderboard(void);
+
+    // Destructor
+    //
+    ~Leaderboard(void);
+
+    // Open
+    // Creates the file if it does not exist yet.
+    //
+    [[nodiscard]] bool open(const std::string& path);
+
+    // Submit
+    // Returns true if the score made it onto the board.
+    //
+    bool submit(const uint32_t score, const uint32_t processId);
+
+    // Snapshot
+    // Best first. Empty slots are left out.
+    //
+    [[nodiscard]] std::vector<LeaderboardEntry> snapshot(void) const;
+
+private:
+    struct Table
+    {
+        uint64_t m_format;
+        uint64_t m_slots[m_capacity];
+    };
+
+    void close(void);
+
+    // Private Data Variables
+    //
+    HANDLE m_file;
+    HANDLE m_mapping;
+    Table* m_table;
+};
@@ -0,0 +1,263 @@
+#include "Level.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+
+namespace
+{
+    constexpr uint32_t LEVEL_MAGIC = 0x564C4246; // "FBLV"
+    constexpr uint32_t LEVEL_VERSION = 1;
+
+    struct LevelHeader
+    {
+        uint32_t m_magic = LEVEL_MAGIC;
+        uint32_t m_version = LEVEL_VERSION;
+        uint64_t m_pipeCount = 0;
+    };
+
+    static_assert(sizeof(LevelHeader) % alignof(LevelPipe) == 0, "Pipes follow the header aligned");
+}
+
+
+// Constructor
+//
+Level::Level(void)
+: m_file(INVALID_HANDLE_VALUE),
+  m_mapping(nullptr),
+  m_view(nullptr),
+  m_pipes(nullptr),
+  m_pipeCount(0),
+  m_releasedBytes(0)
+{
+}
+
+
+// Destructor
+//
+Level::~Level(void)
+{
+    this->close();
+}
+
+
+// Open
+// Only the header is read; the size check is enough to know every pipe
+// is there without touching them.
+//
+bool Level::open(const std::string& path)
+{
+    this->close();
+
+    m_file = CreateFileA(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "Unable to open level file: " << path << std::endl;
+
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(LevelHeader)))
+    {
+        std::cout << "Not a level file: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    m_mapping = CreateFileMapping(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (m_mapping != nullptr)
+    {
+        m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+
+    if (m_view == nullptr)
+    {
+        std::cout << "Unable to map level file: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    const LevelHeader& header = *reinterpret_cast<const LevelHeader*>(m_view);
+
+    if (header.m_magic != LEVEL_MAGIC || header.m_version != LEVEL_VERSION || header.m_pipeCount == 0)
+    {
+        std::cout << "Not a level file, or a different version: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    const uint64_t pipeBytes = static_cast<uint64_t>(fileSize.QuadPart) - sizeof(LevelHeader);
+
+    if (pipeBytes / sizeof(LevelPipe) < header.m_pipeCount)
+    {
+        std::cout << "Level file is truncated: " << path << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    m_pipes = reinterpret_cast<const LevelPipe*>(m_view + sizeof(LevelHeader));
+    m_pipeCount = header.m_pipeCount;
+    m_releasedBytes = 0;
+
+    return true;
+}
+
+
+// Apply
+//
+void Level::apply(GameParameters& parameters) const
+{
+    parameters.m_levelPipes = m_pipes;
+    parameters.m_levelPipeCount = m_pipeCount;
+}
+
+
+// Release
+// In large steps, so it costs nothing on most frames. Unlocking pages that
+// were never locked fails, but takes them out of the working set all the
+// same; being file-backed and unchanged they are simply dropped.
+//
+void Level::release(const uint64_t cursor)
+{
+    constexpr uint64_t releaseBytes = 256 * 1024;
+    constexpr uint64_t pageBytes = 4096;
+
+    if (m_view == nullptr)
+    {
+        return;
+    }
+
+    const uint64_t cursorBytes = sizeof(LevelHeader) + (cursor * sizeof(LevelPipe));
+
+    // Looped round, or rewound, to before what was given back
+    if (cursorBytes < m_releasedBytes)
+    {
+        m_releasedBytes = 0;
+    }
+
+    const uint64_t endBytes = (cursorBytes / pageBytes) * pageBytes;
+
+    if (endBytes < m_releasedBytes + releaseBytes)
+    {
+        return;
+    }
+
+    VirtualUnlock(const_cast<uint8_t*>(m_view) + m_releasedBytes, endBytes - m_releasedBytes);
+    m_releasedBytes = endBytes;
+}
+
+
+// Pipes
+// Accessor for m_pipes
+//
+const LevelPipe* Level::pipes(void) const
+{
+    return m_pipes;
+}
+
+
+// Pipe Count
+// Accessor for m_pipeCount
+//
+uint64_t Level::pipeCount(void) const
+{
+    return m_pipeCount;
+}
+
+
+// Write
+// Streamed out a block at a time, so a course of any length needs the
+// same small buffer.
+//
+bool Level::write(const std::string& path, const uint64_t pipeCount, const uint64_t seed, const int height)
+{
+    constexpr size_t blockPipes = 64 * 1024;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file || pipeCount == 0)
+    {
+        std::cout << "Unable to open level file for writing: " << path << std::endl;
+
+        return false;
+    }
+
+    LevelHeader header;
+    header.m_pipeCount = pipeCount;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    Random random;
+    random.seed(seed);
+
+    const int maxGapStart = std::clamp(height - 12, 2, 18);
+    std::vector<LevelPipe> block(blockPipes);
+
+    for (uint64_t written = 0; written < pipeCount && file; )
+    {
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(blockPipes, pipeCount - written));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            block[i].m_gapSize = static_cast<uint8_t>(random.range(5, 10));
+            block[i].m_gapStartRow = static_cast<uint8_t>(random.range(2, maxGapStart));
+            block[i].m_spacing = static_cast<uint16_t>(random.range(10, 20));
+        }
+
+        file.write(reinterpret_cast<const char*>(block.data()), count * sizeof(LevelPipe));
+        written += count;
+    }
+
+    if (!file)
+    {
+        std::cout << "Unable to write level file: " << path << std::endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+
+// Close
+//
+void Level::close(void)
+{
+    if (m_view != nullptr)
+    {
+        UnmapViewOfFile(m_view);
+        m_view = nullptr;
+    }
+
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+
+    m_pipes = nullptr;
+    m_pipeCount = 0;
+    m_releasedBytes = 0;
+}
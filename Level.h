@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <windows.h>
+
+#include <cstdint>
+#include <string>
+
+
+// Level
+// An authored course in a read-only memory-mapped file: a short header
+// and then one 4-byte LevelPipe per pipe. Opening one reads only the
+// header, and the game reads each pipe straight from the mapping as it
+// comes on, so a course of millions of pipes costs nothing to open and
+// nothing is copied or allocated per pipe. Pages already played through
+// are dropped from the working set as the course goes on, which keeps
+// memory flat over a whole run however long the file is.
+//
+class Level
+{
+public:
+    // Deleted Special Member Functions
+    //
+    Level(const Level& RHS) = delete;
+    Level(Level&& RHS) = delete;
+    Level& operator=(const Level& RHS) = delete;
+    Level& operator=(Level&& RHS) = delete;
+
+    // Constructor
+    //
+    Level(void);
+
+    // Destructor
+    //
+    ~Level(void);
+
+    // Open
+    //
+    [[nodiscard]] bool open(const std::string& path);
+
+    // Apply
+    // Points the parameters at this level's pipes, for as long as it is open.
+    //
+    void apply(GameParameters& parameters) const;
+
+    // Release
+    // Gives back the pages of pipes before the given cursor. They come
+    // back from the file if they are read again.
+    //
+    void release(const uint64_t cursor);
+
+    [[nodiscard]] const LevelPipe* pipes(void) const;
+    [[nodiscard]] uint64_t pipeCount(void) const;
+
+    // Write
+    // A random course of pipeCount pipes, with gaps like the game's own for
+    // a field of the given height and varied spacing.
+    //
+    [[nodiscard]] static bool write(const std::string& path, const uint64_t pipeCount, const uint64_t seed, const int height);
+
+private:
+    void close(void);
+
+    // Private Data Variables
+    //
+    HANDLE m_file;
+    HANDLE m_mapping;
+    const uint8_t* m_view;
+    const LevelPipe* m_pipes;
+    uint64_t m_pipeCount;
+    uint64_t m_releasedBytes;  // From the start of the view
+};
@@ -1,19 +1,584 @@
+#include "Benchmarks.h"
+#include "Configuration.h"
+#include "DifficultyAnalyzer.h"
 #include "FlappyBird.h"
+#include "GridViewer.h"
+#include "Leaderboard.h"
+#include "Level.h"
+#include "Netplay.h"
+#include "PixelCanvas.h"
+#include "Replay.h"
+#include "ReplayRenderer.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+// Render Replay
+// Offline: replay file to an image sequence.
+//
+static int renderReplay(
+    const std::string& replayPath,
+    const std::string& output,
+    const ReplayRenderer::ImageFormat format,
+    const int threadCount)
+{
+    Replay replay;
+
+    if (!replay.load(replayPath))
+    {
+        return EXIT_FAILURE;
+    }
+
+    ReplayRenderer renderer(replay, format, threadCount);
+
+    return renderer.render(output) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
+// Analyze Difficulty
+// Offline: survival odds for the configured physics, then a sweep.
+//
+static int analyzeDifficulty(const Configuration& configuration, const int threadCount)
+{
+    using namespace std::chrono;
+
+    constexpr double tickSeconds = 1.0 / 60.0;
+    constexpr int courses = 200;
+    constexpr int targetPipes = 20;
+    const uint64_t firstSeed = configuration.m_seed.value_or(1);
+
+    std::vector<GameParameters> parameterSets;
+    parameterSets.push_back(configuration.m_parameters);
+
+    for (const double jumpVelocity : { 8.0, 12.0, 15.0, 20.0, 25.0 })
+    {
+        for (const double pipeVelocity : { 10.0, 15.0, 25.0, 40.0 })
+        {
+            for (const double gravity : { 20.0, 40.0, 80.0, 160.0 })
+            {
+                GameParameters parameters = configuration.m_parameters;
+                parameters.m_jumpVelocity = jumpVelocity;
+                parameters.m_pipeVelocity = pipeVelocity;
+                parameters.m_gravity = gravity;
+                parameterSets.push_back(parameters);
+            }
+        }
+    }
+
+    std::cout << "Analyzing " << parameterSets.size() << " parameter sets x " << courses
+              << " courses x " << targetPipes << " pipes on " << threadCount << " threads ("
+              << (DifficultyAnalyzer::usesAVX2() ? "AVX2" : "scalar") << ")" << std::endl;
+
+    const auto start = high_resolution_clock::now();
+    const auto reports = DifficultyAnalyzer::sweep(
+        parameterSets, tickSeconds, firstSeed, courses, targetPipes, threadCount);
+    const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+
+    std::cout << "   jump    pipe gravity  survival  mean pipes" << std::endl;
+
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        const DifficultyReport& report = reports[i];
+        char line[128];
+        std::snprintf(
+            line,
+            sizeof(line),
+            "%7.1f %7.1f %7.1f %8.1f%% %11.2f%s",
+            report.m_parameters.m_jumpVelocity,
+            report.m_parameters.m_pipeVelocity,
+            report.m_parameters.m_gravity,
+            report.m_survivalProbability * 100.0,
+            report.m_meanPipesPassed,
+            i == 0 ? "  (configured)" : "");
+        std::cout << line << std::endl;
+    }
+
+    std::cout << "Sweep took " << seconds << " s" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+
+// Show Leaderboard
+//
+static int showLeaderboard(const std::string& path)
+{
+    Leaderboard leaderboard;
+
+    if (!leaderboard.open(path))
+    {
+        return EXIT_FAILURE;
+    }
+
+    int rank = 1;
+
+    for (const LeaderboardEntry& entry : leaderboard.snapshot())
+    {
+        std::cout << rank++ << ". " << entry.m_score << "  (process " << entry.m_processId << ")" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+
+// Show Grid
+// Bots playing columns x rows games at once, tiled over the configured
+// window. Each game keeps the usual field size, scaled down to its tile.
+//
+static int showGrid(const Configuration& configuration, const int columns, const int rows, const int threadCount)
+{
+    GameParameters parameters = configuration.m_parameters;
+    parameters.m_width = GameParameters().m_width;
+    parameters.m_height = GameParameters().m_height;
+
+    GridViewer viewer(
+        L"Flappy Bird",
+        configuration.m_parameters.m_width,
+        configuration.m_parameters.m_height,
+        parameters,
+        columns,
+        rows,
+        configuration.m_seed.value_or(1),
+        threadCount);
+
+    if (!viewer.initializeConsole())
+    {
+        return EXIT_FAILURE;
+    }
+
+    const int result = viewer.gameLoop();
+
+    return Trace::flush() ? result : EXIT_FAILURE;
+}
+
+
+// Option Value Count
+// How many values follow the flag on the command line. Switches, and
+// anything not an option, take none.
+//
+static int optionValueCount(const std::string_view argument)
+{
+    if (argument.starts_with("--") && Configuration::isKey(argument.substr(2)))
+    {
+        return 1;
+    }
+
+    if (argument == "--leaderboard-writer"
+        || argument == "--versus"
+        || argument == "--make-level"
+        || argument == "--render-replay")
+    {
+        return 2;
+    }
+
+    if (argument == "--leaderboard-stress"
+        || argument == "--config"
+        || argument == "--leaderboard"
+        || argument == "--hires"
+        || argument == "--lag"
+        || argument == "--loss"
+        || argument == "--grid"
+        || argument == "--sensors"
+        || argument == "--level"
+        || argument == "--record"
+        || argument == "--threads"
+        || argument == "--trace")
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+
+// Print Usage
+// The options in brief; README.md says what each one does.
+//
+static void printUsage(void)
+{
+    std::cout
+        << "Usage: FlappyBird.exe [options]\n"
+        << "  --jump-velocity V  --pipe-velocity V  --gravity G  --seed N\n"
+        << "  --width W  --height H  --config FILE  --startup-time\n"
+        << "  --autopilot  --hires half|braille  --bands  --threads N\n"
+        << "  --record FILE  --render-replay FILE OUT  --png\n"
+        << "  --analyze-difficulty  --leaderboard FILE  --show-leaderboard\n"
+        << "  --versus PORT PEER_PORT  --lag MS  --loss PERCENT\n"
+        << "  --grid CxR  --practice  --sensors N  --level FILE\n"
+        << "  --make-level FILE N  --trace FILE\n"
+        << "  --bench-search  --bench-render  --bench-bands  --bench-episodes\n"
+        << "  --bench-grid  --bench-rewind  --bench-sensors  --bench-level\n"
+        << "  --versus-test  --leaderboard-stress N" << std::endl;
+}
 
 
 // Main method
 //
-int main(void)
+int main(int argc, char* argv[])
 {
-    constexpr int WIDTH = 120;
-    constexpr int HEIGHT = 30;
+    Configuration configuration;
+    bool autopilot = false;
+    bool measureStartup = false;
+    bool difficulty = false;
+    bool leaderboard = false;
+    std::string leaderboardPath = "FlappyBird.leaderboard";
+    std::string recordPath;
+    std::string levelPath;
+    std::string makeLevelPath;
+    uint64_t makeLevelPipes = 0;
+    std::string replayPath;
+    std::string renderOutput;
+    int threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    auto imageFormat = ReplayRenderer::ImageFormat::PPM;
+    std::optional<PixelCanvas::Mode> highResolution;
+    std::optional<VersusOptions> versus;
+    bool banded = false;
+    bool practice = false;
+    int sensorRays = 0;
+    int gridColumns = 0;
+    int gridRows = 0;
+    LinkConditions linkConditions;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view argument = argv[i];
+        const int valueCount = optionValueCount(argument);
+
+        // A flag left without its values would otherwise start some other game
+        if (i + valueCount >= argc)
+        {
+            std::cout << argument << " expects " << valueCount << (valueCount == 1 ? " value." : " values.") << std::endl;
+            printUsage();
+            return EXIT_FAILURE;
+        }
+
+        if (argument == "--bench-search")
+        {
+            return Benchmarks::searchNodesPerSecond();
+        }
+        else if (argument == "--bench-render")
+        {
+            return Benchmarks::renderFramesPerSecond();
+        }
+        else if (argument == "--bench-bands")
+        {
+            return Benchmarks::compositorScaling();
+        }
+        else if (argument == "--bench-episodes")
+        {
+            return Benchmarks::episodeThroughput();
+        }
+        else if (argument == "--bench-grid")
+        {
+            return Benchmarks::gridFrameTime();
+        }
+        else if (argument == "--bench-sensors")
+        {
+            return Benchmarks::sensorRays();
+        }
+        else if (argument == "--bench-rewind")
+        {
+            return Benchmarks::rewindHistory();
+        }
+        else if (argument == "--bench-level")
+        {
+            return Benchmarks::levelStreaming();
+        }
+        else if (argument == "--versus-test")
+        {
+            return Benchmarks::versusLoopback();
+        }
+        else if (argument == "--leaderboard-stress")
+        {
+            return Benchmarks::leaderboardStress(std::atoi(argv[++i]));
+        }
+        else if (argument == "--leaderboard-writer")
+        {
+            const std::string path = argv[++i];
+            return Benchmarks::leaderboardWriter(path, std::atoi(argv[++i]));
+        }
+        else if (argument.starts_with("--") && Configuration::isKey(argument.substr(2)))
+        {
+            if (!configuration.set(argument.substr(2), argv[++i]))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argument == "--config")
+        {
+            if (!configuration.loadFile(argv[++i]))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argument == "--leaderboard")
+        {
+            leaderboardPath = argv[++i];
+        }
+        else if (argument == "--show-leaderboard")
+        {
+            leaderboard = true;
+        }
+        else if (argument == "--analyze-difficulty")
+        {
+            difficulty = true;
+        }
+        else if (argument == "--startup-time")
+        {
+            measureStartup = true;
+        }
+        else if (argument == "--hires")
+        {
+            const std::string_view mode = argv[++i];
+
+            if (mode == "half")
+            {
+                highResolution = PixelCanvas::Mode::HALF_BLOCK;
+            }
+            else if (mode == "braille")
+            {
+                highResolution = PixelCanvas::Mode::BRAILLE;
+            }
+            else
+            {
+                std::cout << "Unknown --hires mode: " << mode << " (expected half or braille)" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argument == "--versus")
+        {
+            VersusOptions options;
+            options.m_localPort = static_cast<uint16_t>(std::atoi(argv[++i]));
+            options.m_remotePort = static_cast<uint16_t>(std::atoi(argv[++i]));
+            versus = options;
+        }
+        else if (argument == "--lag")
+        {
+            linkConditions.m_delayMilliseconds = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (argument == "--loss")
+        {
+            linkConditions.m_lossPercent = std::clamp(std::atoi(argv[++i]), 0, 100);
+        }
+        else if (argument == "--bands")
+        {
+            banded = true;
+        }
+        else if (argument == "--grid")
+        {
+            const std::string_view size = argv[++i];
+            const size_t separator = size.find('x');
+
+            if (separator != std::string_view::npos)
+            {
+                gridColumns = std::atoi(std::string(size.substr(0, separator)).c_str());
+                gridRows = std::atoi(std::string(size.substr(separator + 1)).c_str());
+            }
+
+            if (gridColumns <= 0 || gridRows <= 0)
+            {
+                std::cout << "Expected --grid COLUMNSxROWS, such as 8x8: " << size << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argument == "--sensors")
+        {
+            sensorRays = std::clamp(std::atoi(argv[++i]), 1, 64);
+        }
+        else if (argument == "--practice")
+        {
+            practice = true;
+        }
+        else if (argument == "--autopilot")
+        {
+            autopilot = true;
+        }
+        else if (argument == "--level")
+        {
+            levelPath = argv[++i];
+        }
+        else if (argument == "--make-level")
+        {
+            makeLevelPath = argv[++i];
+            makeLevelPipes = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (argument == "--record")
+        {
+            recordPath = argv[++i];
+        }
+        else if (argument == "--render-replay")
+        {
+            replayPath = argv[++i];
+            renderOutput = argv[++i];
+        }
+        else if (argument == "--threads")
+        {
+            threadCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (argument == "--trace")
+        {
+            Trace::enable(argv[++i]);
+        }
+        else if (argument == "--png")
+        {
+            imageFormat = ReplayRenderer::ImageFormat::PNG;
+        }
+        else
+        {
+            std::cout << "Unknown option: " << argument << std::endl;
+            printUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (leaderboard)
+    {
+        return showLeaderboard(leaderboardPath);
+    }
+
+    if (difficulty)
+    {
+        return analyzeDifficulty(configuration, threadCount);
+    }
+
+    if (!replayPath.empty())
+    {
+        return renderReplay(replayPath, renderOutput, imageFormat, threadCount);
+    }
+
+    if (!makeLevelPath.empty())
+    {
+        const uint64_t seed = configuration.m_seed.value_or(1);
+        const int height = configuration.m_parameters.m_height;
+
+        return Level::write(makeLevelPath, makeLevelPipes, seed, height) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // A replay saves no level, so it could not play the course back
+    if (!levelPath.empty() && !recordPath.empty())
+    {
+        std::cout << "--level cannot be combined with --record." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Stays open until the game is over
+    Level level;
+
+    if (!levelPath.empty())
+    {
+        if (!level.open(levelPath))
+        {
+            return EXIT_FAILURE;
+        }
+
+        level.apply(configuration.m_parameters);
+    }
+
+    if (gridColumns > 0)
+    {
+        return showGrid(configuration, gridColumns, gridRows, threadCount);
+    }
+
+    const int width = configuration.m_parameters.m_width;
+    const int height = configuration.m_parameters.m_height;
     const std::wstring gameTitle = L"Flappy Bird";
-    FlappyBird flappyBird(gameTitle, WIDTH, HEIGHT);
+    FlappyBird flappyBird(gameTitle, width, height);
+
+    if (configuration.m_parametersSupplied)
+    {
+        flappyBird.setParameters(configuration.m_parameters);
+    }
+
+    if (configuration.m_seed.has_value())
+    {
+        flappyBird.setSeed(configuration.m_seed.value());
+    }
+
+    if (measureStartup)
+    {
+        flappyBird.measureStartup();
+    }
+
+    if (autopilot)
+    {
+        flappyBird.enableAutopilot();
+    }
+
+    if (!recordPath.empty())
+    {
+        flappyBird.enableRecording(recordPath);
+    }
+
+    if (highResolution.has_value())
+    {
+        flappyBird.enableHighResolution(highResolution.value());
+    }
+
+    if (banded)
+    {
+        flappyBird.enableBandedCompositor(threadCount);
+    }
+
+    if (sensorRays > 0)
+    {
+        flappyBird.enableSensors(sensorRays);
+    }
+
+    if (!levelPath.empty())
+    {
+        flappyBird.enableLevel(level);
+    }
+
+    // Rewinding would leave the peer or the replay file out of step
+    if (practice && (versus.has_value() || !recordPath.empty()))
+    {
+        std::cout << "--practice cannot be combined with --versus or --record." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (practice)
+    {
+        flappyBird.enablePractice();
+    }
+
+    if (versus.has_value())
+    {
+        versus->m_conditions = linkConditions;
+
+        if (!flappyBird.enableVersus(versus.value()))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+
+    flappyBird.enableLeaderboard(leaderboardPath);
 
     if (!flappyBird.initializeConsole())
     {
         return EXIT_FAILURE;
     }
 
-    return flappyBird.gameLoop();
-}
\ No newline at end of file
+    const int result = flappyBird.gameLoop();
+
+    if (!Trace::flush())
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (measureStartup)
+    {
+        std::cout << "Process start to first frame: " << flappyBird.startupMilliseconds() << " ms" << std::endl;
+    }
+
+    return result;
+}
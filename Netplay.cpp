@@ -0,0 +1,382 @@
+#include "Netplay.h"
+#include "Trace.h"
+
+#include <winsock2.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef _MSC_VER
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+
+
+namespace
+{
+    // After a stall, catch up by at most this many ticks per frame
+    constexpr double MAX_CATCH_UP_TICKS = 4.0;
+
+    sockaddr_in loopbackAddress(const uint16_t port)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+
+        return address;
+    }
+}
+
+
+// Constructor
+//
+UdpLink::UdpLink(void)
+: m_socket(static_cast<uintptr_t>(INVALID_SOCKET)),
+  m_winsockStarted(false),
+  m_remotePort(0),
+  m_conditions(),
+  m_random(),
+  m_pending()
+{
+}
+
+
+// Destructor
+//
+UdpLink::~UdpLink(void)
+{
+    this->close();
+}
+
+
+// Open
+//
+bool UdpLink::open(
+    const uint16_t localPort,
+    const uint16_t remotePort,
+    const LinkConditions& conditions,
+    const uint64_t seed)
+{
+    this->close();
+
+    WSADATA data;
+
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        std::cout << "Unable to start Winsock." << std::endl;
+
+        return false;
+    }
+
+    m_winsockStarted = true;
+
+    const SOCKET udpSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+    if (udpSocket == INVALID_SOCKET)
+    {
+        std::cout << "Unable to create a UDP socket." << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    m_socket = static_cast<uintptr_t>(udpSocket);
+
+    const sockaddr_in local = loopbackAddress(localPort);
+
+    if (bind(udpSocket, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) == SOCKET_ERROR)
+    {
+        std::cout << "Unable to bind UDP port " << localPort << "." << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    u_long nonBlocking = 1;
+
+    if (ioctlsocket(udpSocket, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+    {
+        std::cout << "Unable to make the UDP socket non-blocking." << std::endl;
+        this->close();
+
+        return false;
+    }
+
+    m_remotePort = remotePort;
+    m_conditions = conditions;
+    m_random.seed(seed);
+
+    return true;
+}
+
+
+// Send
+//
+void UdpLink::send(const void* data, const size_t size, const double now)
+{
+    if (size > m_maxDatagram)
+    {
+        return;
+    }
+
+    if (m_random.range(0, 99) < m_conditions.m_lossPercent)
+    {
+        return;
+    }
+
+    // The delay is fixed, so the queue stays in due order
+    Datagram& datagram = m_pending.emplace_back();
+    datagram.m_due = now + (m_conditions.m_delayMilliseconds * 1e-3);
+    datagram.m_size = size;
+    std::memcpy(datagram.m_bytes, data, size);
+
+    this->flush(now);
+}
+
+
+// Flush
+//
+void UdpLink::flush(const double now)
+{
+    if (m_socket == static_cast<uintptr_t>(INVALID_SOCKET))
+    {
+        return;
+    }
+
+    const sockaddr_in remote = loopbackAddress(m_remotePort);
+
+    while (!m_pending.empty() && m_pending.front().m_due <= now)
+    {
+        const Datagram& datagram = m_pending.front();
+
+        // Best effort, like the network it stands in for
+        sendto(
+            static_cast<SOCKET>(m_socket),
+            datagram.m_bytes,
+            static_cast<int>(datagram.m_size),
+            0,
+            reinterpret_cast<const sockaddr*>(&remote),
+            sizeof(remote));
+
+        m_pending.pop_front();
+    }
+}
+
+
+// Receive
+//
+size_t UdpLink::receive(void* data, const size_t capacity)
+{
+    if (m_socket == static_cast<uintptr_t>(INVALID_SOCKET))
+    {
+        return 0;
+    }
+
+    for (;;)
+    {
+        const int size = recvfrom(
+            static_cast<SOCKET>(m_socket),
+            static_cast<char*>(data),
+            static_cast<int>(capacity),
+            0,
+            nullptr,
+            nullptr);
+
+        if (size >= 0)
+        {
+            return static_cast<size_t>(size);
+        }
+
+        // Windows reports an earlier send to a port nobody had bound yet
+        // (the peer not started) as a reset on the next receive. Skip it.
+        if (WSAGetLastError() != WSAECONNRESET)
+        {
+            return 0;
+        }
+    }
+}
+
+
+// Close
+//
+void UdpLink::close(void)
+{
+    if (m_socket != static_cast<uintptr_t>(INVALID_SOCKET))
+    {
+        closesocket(static_cast<SOCKET>(m_socket));
+        m_socket = static_cast<uintptr_t>(INVALID_SOCKET);
+    }
+
+    if (m_winsockStarted)
+    {
+        WSACleanup();
+        m_winsockStarted = false;
+    }
+
+    m_pending.clear();
+}
+
+
+// Constructor
+//
+VersusMatch::VersusMatch(const VersusOptions& options, const double tickSeconds)
+: m_options(options),
+  m_tickSeconds(tickSeconds),
+  m_link(),
+  m_session(nullptr),
+  m_clock(0.0),
+  m_tickTime(0.0),
+  m_sendTime(0.0),
+  m_pendingJump(false)
+{
+}
+
+
+// Open
+//
+bool VersusMatch::open(void)
+{
+    return m_link.open(m_options.m_localPort, m_options.m_remotePort, m_options.m_conditions, m_options.m_localPort);
+}
+
+
+// Start
+// Both sides agree on who is who by port order alone.
+//
+void VersusMatch::start(const GameParameters& parameters, const Random& course)
+{
+    const int localPlayer = (m_options.m_localPort < m_options.m_remotePort) ? 0 : 1;
+
+    m_session = std::make_unique<RollbackSession>(parameters, course, localPlayer, m_tickSeconds);
+    m_tickTime = 0.0;
+    m_sendTime = 0.0;
+    m_pendingJump = false;
+}
+
+
+// Update
+//
+void VersusMatch::update(const double deltaTime, const bool jump)
+{
+    TRACE_SCOPE("VersusMatch::update");
+
+    m_clock += deltaTime;
+    m_pendingJump = m_pendingJump || jump;
+
+    this->receivePackets();
+
+    m_tickTime = std::min(m_tickTime + deltaTime, MAX_CATCH_UP_TICKS * m_tickSeconds);
+
+    while (m_tickTime >= m_tickSeconds && m_session->canAdvance() && !m_session->finished())
+    {
+        m_session->advance(m_pendingJump);
+        m_pendingJump = false;
+        m_tickTime -= m_tickSeconds;
+    }
+
+    // The frame loop is unthrottled, so send on the tick rate, not per frame
+    m_sendTime += deltaTime;
+
+    if (m_sendTime >= m_tickSeconds)
+    {
+        m_sendTime = std::fmod(m_sendTime, m_tickSeconds);
+        this->sendPacket();
+    }
+
+    m_link.flush(m_clock);
+}
+
+
+// Linger
+//
+void VersusMatch::linger(const double seconds)
+{
+    for (double waited = 0.0; waited < seconds && !m_session->peerCaughtUp(); waited += m_tickSeconds)
+    {
+        this->receivePackets();
+        this->sendPacket();
+        m_link.flush(m_clock);
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(m_tickSeconds));
+        m_clock += m_tickSeconds;
+    }
+}
+
+
+// Finished
+//
+bool VersusMatch::finished(void) const
+{
+    return m_session->finished();
+}
+
+
+// Waiting
+//
+bool VersusMatch::waiting(void) const
+{
+    return !m_session->canAdvance();
+}
+
+
+// Local
+//
+const GameState& VersusMatch::local(void) const
+{
+    return m_session->local();
+}
+
+
+// Rival
+//
+const GameState& VersusMatch::rival(void) const
+{
+    return m_session->rival();
+}
+
+
+// Statistics
+//
+const RollbackStatistics& VersusMatch::statistics(void) const
+{
+    return m_session->statistics();
+}
+
+
+// Receive Packets
+// Anything short, or with a jump count that does not match its size, is
+// not one of ours.
+//
+void VersusMatch::receivePackets(void)
+{
+    InputPacket packet;
+
+    for (;;)
+    {
+        const size_t size = m_link.receive(&packet, sizeof(packet));
+
+        if (size == 0)
+        {
+            break;
+        }
+
+        if (size >= offsetof(InputPacket, m_jumpTicks) && packet.size() == size)
+        {
+            m_session->receive(packet);
+        }
+    }
+}
+
+
+// Send Packet
+//
+void VersusMatch::sendPacket(void)
+{
+    const InputPacket packet = m_session->makePacket();
+
+    m_link.send(&packet, packet.size(), m_clock);
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "Rollback.h"
+#include "Simulation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+
+// Network conditions to simulate on the way out of a link
+//
+struct LinkConditions
+{
+    int m_delayMilliseconds = 0;
+    int m_lossPercent = 0;
+};
+
+
+struct VersusOptions
+{
+    uint16_t m_localPort = 0;
+    uint16_t m_remotePort = 0;
+    LinkConditions m_conditions;
+};
+
+
+// UdpLink
+// A non-blocking UDP socket on the loopback address talking to one other
+// port. Outgoing datagrams pass through a delay and loss injector first,
+// so two games on one machine can play as if across a real network.
+//
+class UdpLink
+{
+public:
+    static constexpr int m_maxDatagram = 1024;
+
+    // Deleted Special Member Functions
+    //
+    UdpLink(const UdpLink& RHS) = delete;
+    UdpLink(UdpLink&& RHS) = delete;
+    UdpLink& operator=(const UdpLink& RHS) = delete;
+    UdpLink& operator=(UdpLink&& RHS) = delete;
+
+    // Constructor
+    //
+    UdpLink(void);
+
+    // Destructor
+    //
+    ~UdpLink(void);
+
+    // Open
+    // The seed drives the loss injector, so a test run drops the same
+    // packets every time.
+    //
+    [[nodiscard]] bool open(
+        const uint16_t localPort,
+        const uint16_t remotePort,
+        const LinkConditions& conditions,
+        const uint64_t seed);
+
+    // Send
+    // Queues the datagram to leave once the injected delay has passed,
+    // unless the injector drops it. Times are in seconds on any clock, as
+    // long as flush() is given the same one.
+    //
+    void send(const void* data, const size_t size, const double now);
+
+    // Flush
+    // Puts every queued datagram that is due on the wire.
+    //
+    void flush(const double now);
+
+    // Receive
+    // Returns the size of the next waiting datagram, or 0 if there is none.
+    //
+    [[nodiscard]] size_t receive(void* data, const size_t capacity);
+
+private:
+    struct Datagram
+    {
+        double m_due = 0.0;
+        size_t m_size = 0;
+        char m_bytes[m_maxDatagram];
+    };
+
+    void close(void);
+
+    // Private Data Variables
+    //
+    uintptr_t m_socket; // A SOCKET; kept as an integer so this header does not need winsock2.h
+    bool m_winsockStarted;
+    uint16_t m_remotePort;
+    LinkConditions m_conditions;
+    Random m_random;
+    std::deque<Datagram> m_pending;
+};
+
+
+// VersusMatch
+// One versus round over a UdpLink: paces the rollback session on a fixed
+// tick against the frame clock and trades input packets with the peer.
+//
+class VersusMatch
+{
+public:
+    // Deleted Special Member Functions
+    //
+    VersusMatch(void) = delete;
+    VersusMatch(const VersusMatch& RHS) = delete;
+    VersusMatch(VersusMatch&& RHS) = delete;
+    VersusMatch& operator=(const VersusMatch& RHS) = delete;
+    VersusMatch& operator=(VersusMatch&& RHS) = delete;
+
+    // Constructor
+    //
+    VersusMatch(const VersusOptions& options, const double tickSeconds);
+
+    // Destructor
+    //
+    ~VersusMatch(void) = default;
+
+    [[nodiscard]] bool open(void);
+
+    // Start
+    // A fresh round on the course the RNG will lay out. Both sides must
+    // pass the same physics and the same RNG.
+    //
+    void start(const GameParameters& parameters, const Random& course);
+
+    // Update
+    // Called every frame. A jump is held until the next tick plays it.
+    //
+    void update(const double deltaTime, const bool jump);
+
+    // Linger
+    // Keeps trading packets after the round until the peer has every local
+    // input, or the time runs out, so it can finish the round too.
+    //
+    void linger(const double seconds);
+
+    [[nodiscard]] bool finished(void) const;
+
+    // Waiting
+    // A window ahead of the peer and held back until it catches up.
+    //
+    [[nodiscard]] bool waiting(void) const;
+
+    [[nodiscard]] const GameState& local(void) const;
+    [[nodiscard]] const GameState& rival(void) const;
+    [[nodiscard]] const RollbackStatistics& statistics(void) const;
+
+private:
+    void receivePackets(void);
+    void sendPacket(void);
+
+    // Private Data Variables
+    //
+    VersusOptions m_options;
+    double m_tickSeconds;
+    UdpLink m_link;
+    std::unique_ptr<RollbackSession> m_session;
+    double m_clock;
+    double m_tickTime;
+    double m_sendTime;
+    bool m_pendingJump;
+};
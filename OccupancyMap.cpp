@@ -0,0 +1,339 @@
+#include "OccupancyMap.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+
+namespace
+{
+    // Bits [first, last] of a word, with 0 <= first <= last < 64
+    uint64_t bitRange(const int first, const int last)
+    {
+        return (~0ull >> (63 - last)) & (~0ull << first);
+    }
+
+    // Bits [first, last] of a run of words
+    void setRange(uint64_t* words, const int first, const int last)
+    {
+        for (int word = first / 64; word <= last / 64; ++word)
+        {
+            words[word] |= bitRange(std::max(first - (word * 64), 0), std::min(last - (word * 64), 63));
+        }
+    }
+}
+
+
+// Constructor
+//
+OccupancyMap::OccupancyMap(const int width, const int height)
+: m_width(std::max(width, 1)),
+  m_height(std::max(height, 1)),
+  m_wordsPerColumn(0),
+  m_columns(),
+  m_runs()
+{
+    m_wordsPerColumn = (m_height + 63) / 64;
+    m_columns.resize(static_cast<size_t>(m_wordsPerColumn) * m_width);
+    m_runs.reserve(GameState::m_pipeCount);
+}
+
+
+// Build
+// Each pipe is the same run of bits down each of its columns.
+//
+void OccupancyMap::build(const GameState& state)
+{
+    TRACE_SCOPE("OccupancyMap::build");
+
+    std::fill(m_columns.begin(), m_columns.end(), 0ull);
+    m_runs.clear();
+
+    for (const Pipe& pipe : state.m_pipes)
+    {
+        if (!pipe.isVisible(m_width))
+        {
+            continue;
+        }
+
+        const int firstCol = pipe.m_col;
+        const int lastCol = pipe.m_col + pipe.m_width - 1;
+        const int gapStart = std::clamp(pipe.m_gapStartRow, 0, m_height);
+        const int gapEnd = std::clamp(pipe.m_gapStartRow + pipe.m_gapSize, gapStart, m_height);
+
+        // Build one column and copy it
+        uint64_t* column = m_columns.data() + (static_cast<size_t>(firstCol) * m_wordsPerColumn);
+
+        if (gapStart > 0)
+        {
+            setRange(column, 0, gapStart - 1);
+        }
+
+        if (gapEnd < m_height)
+        {
+            setRange(column, gapEnd, m_height - 1);
+        }
+
+        for (int col = firstCol + 1; col <= lastCol; ++col)
+        {
+            std::copy(column, column + m_wordsPerColumn, m_columns.data() + (static_cast<size_t>(col) * m_wordsPerColumn));
+        }
+
+        ColumnRun run;
+        run.m_first = firstCol;
+        run.m_last = lastCol;
+        m_runs.push_back(run);
+    }
+
+    // Already in order for any course the simulation lays out
+    std::sort(m_runs.begin(), m_runs.end(), [](const ColumnRun& a, const ColumnRun& b) { return a.m_first < b.m_first; });
+}
+
+
+// Occupied
+//
+bool OccupancyMap::occupied(const int row, const int col) const
+{
+    if (row < 0 || row >= m_height)
+    {
+        return true;
+    }
+
+    if (col < 0 || col >= m_width)
+    {
+        return false;
+    }
+
+    return (m_columns[(static_cast<size_t>(col) * m_wordsPerColumn) + (row / 64)] >> (row % 64)) & 1;
+}
+
+
+// Cast Ray
+//
+double OccupancyMap::castRay(const int row, const int col, const Ray& ray) const
+{
+    if (this->occupied(row, col))
+    {
+        return 0.0;
+    }
+
+    size_t ahead = 0;
+    size_t behind = 0;
+    this->findRuns(col, ahead, behind);
+
+    return this->castFrom(row, col, ray, ahead, behind);
+}
+
+
+// Cast Rays
+//
+void OccupancyMap::castRays(const int row, const int col, const std::vector<Ray>& rays, double* distances) const
+{
+    TRACE_SCOPE("OccupancyMap::castRays");
+
+    if (this->occupied(row, col))
+    {
+        std::fill(distances, distances + rays.size(), 0.0);
+
+        return;
+    }
+
+    size_t ahead = 0;
+    size_t behind = 0;
+    this->findRuns(col, ahead, behind);
+
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        distances[i] = this->castFrom(row, col, rays[i], ahead, behind);
+    }
+}
+
+
+// Find Runs
+//
+void OccupancyMap::findRuns(const int col, size_t& ahead, size_t& behind) const
+{
+    ahead = 0;
+    behind = 0;
+
+    for (const ColumnRun& run : m_runs)
+    {
+        ahead += (run.m_last < col) ? 1 : 0;
+        behind += (run.m_first <= col) ? 1 : 0;
+    }
+}
+
+
+// Cast From
+// Visits the runs the ray reaches in the order it reaches them. Within a
+// run every column is the same, so the ray meets the first occupied row it
+// covers there, found with one bit scan, at the later of entering the run
+// and entering that row. Leaving the field through the top or bottom is a
+// hit there; leaving through a side never comes back.
+//
+double OccupancyMap::castFrom(const int row, const int col, const Ray& ray, const size_t ahead, const size_t behind) const
+{
+    const double dx = ray.m_direction.m_col;
+    const double dy = ray.m_direction.m_row;
+    const double originCol = col + 0.5;
+    const double originRow = row + 0.5;
+
+    // Out through the top or bottom, unless it had already left by a side
+    double tEdge = std::numeric_limits<double>::infinity();
+    double miss = ray.m_maxDistance;
+
+    if (dy != 0.0)
+    {
+        tEdge = ((dy > 0.0) ? m_height - originRow : originRow) * ray.m_tPerRow;
+        const double xEdge = originCol + (dx * tEdge);
+
+        if (tEdge < ray.m_maxDistance && xEdge >= 0.0 && xEdge < m_width)
+        {
+            miss = tEdge;
+        }
+    }
+
+    const double tEnd = std::min(tEdge, ray.m_maxDistance);
+
+    // Straight up or down counts as rightwards: only a run holding the start
+    // column has a finite distance to it
+    const bool rightwards = (dx >= 0.0);
+    const size_t count = rightwards ? m_runs.size() - ahead : behind;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const ColumnRun& run = rightwards ? m_runs[ahead + i] : m_runs[behind - 1 - i];
+        const double colsToEnter = rightwards ? run.m_first - originCol : originCol - (run.m_last + 1);
+        const double colsToLeave = rightwards ? (run.m_last + 1) - originCol : originCol - run.m_first;
+        const double tIn = std::max(colsToEnter * ray.m_tPerCol, 0.0);
+
+        if (tIn >= tEnd)
+        {
+            break;
+        }
+
+        const double tOut = std::min(colsToLeave * ray.m_tPerCol, tEnd);
+        const double rowIn = originRow + (dy * tIn);
+        const double rowOut = originRow + (dy * tOut);
+
+        // Never above the field before tEnd, so truncating is flooring
+        const int firstRow = std::max(static_cast<int>(std::min(rowIn, rowOut)), 0);
+        const int lastRow = std::min(static_cast<int>(std::max(rowIn, rowOut)), m_height - 1);
+
+        const uint64_t* words = m_columns.data() + (static_cast<size_t>(run.m_first) * m_wordsPerColumn);
+        int hit = -1;
+
+        // Fields up to 64 rows tall, which is nearly all of them, take one word
+        if (m_wordsPerColumn == 1)
+        {
+            const uint64_t bits = words[0] & bitRange(firstRow, lastRow);
+
+            if (bits != 0)
+            {
+                hit = (dy >= 0.0) ? std::countr_zero(bits) : 63 - std::countl_zero(bits);
+            }
+        }
+        else
+        {
+            hit = OccupancyMap::findInColumn(words, firstRow, lastRow, dy >= 0.0);
+        }
+
+        if (hit >= 0)
+        {
+            double tHit = tIn;
+
+            if (dy > 0.0)
+            {
+                tHit = std::max(tHit, (hit - originRow) * ray.m_tPerRow);
+            }
+            else if (dy < 0.0)
+            {
+                tHit = std::max(tHit, (originRow - (hit + 1)) * ray.m_tPerRow);
+            }
+
+            return std::min(tHit, ray.m_maxDistance);
+        }
+    }
+
+    return miss;
+}
+
+
+// Prepare Ray
+//
+OccupancyMap::Ray OccupancyMap::prepareRay(const Direction& direction, const double maxDistance)
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    Ray ray;
+    ray.m_direction = direction;
+    ray.m_maxDistance = maxDistance;
+    ray.m_tPerCol = (direction.m_col != 0.0) ? 1.0 / std::abs(direction.m_col) : infinity;
+    ray.m_tPerRow = (direction.m_row != 0.0) ? 1.0 / std::abs(direction.m_row) : infinity;
+
+    return ray;
+}
+
+
+// Fan
+//
+std::vector<OccupancyMap::Ray> OccupancyMap::fan(const int count, const double maxDistance)
+{
+    std::vector<Direction> directions(std::max(count, 0));
+
+    for (int i = 0; i < count && count > 1; ++i)
+    {
+        const double angle = std::numbers::pi * ((static_cast<double>(i) / (count - 1)) - 0.5);
+        directions[i].m_col = std::cos(angle);
+        directions[i].m_row = std::sin(angle);
+    }
+
+    // Exact at the ends and in the middle, so those rays keep to one column or row
+    if (count > 1)
+    {
+        directions.front() = { 0.0, -1.0 };
+        directions.back() = { 0.0, 1.0 };
+    }
+
+    if (count % 2 == 1)
+    {
+        directions[count / 2] = { 1.0, 0.0 };
+    }
+
+    std::vector<Ray> rays;
+    rays.reserve(directions.size());
+
+    for (const Direction& direction : directions)
+    {
+        rays.push_back(OccupancyMap::prepareRay(direction, maxDistance));
+    }
+
+    return rays;
+}
+
+
+// Find In Column
+//
+int OccupancyMap::findInColumn(const uint64_t* words, const int first, const int last, const bool fromFirst)
+{
+    const int firstWord = first / 64;
+    const int lastWord = last / 64;
+
+    for (int i = 0; i <= lastWord - firstWord; ++i)
+    {
+        const int word = fromFirst ? firstWord + i : lastWord - i;
+        const int low = std::max(first - (word * 64), 0);
+        const int high = std::min(last - (word * 64), 63);
+        const uint64_t bits = words[word] & bitRange(low, high);
+
+        if (bits != 0)
+        {
+            return (word * 64) + (fromFirst ? std::countr_zero(bits) : 63 - std::countl_zero(bits));
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <cstdint>
+#include <vector>
+
+
+// OccupancyMap
+// The field as one bit per cell, set wherever a pipe's body is, rebuilt
+// from the pipe list each tick. Each column is a run of 64-bit words down
+// the field, so a collision test is one bit. Every column of a pipe is the
+// same, so the map also keeps the pipes as runs of identical columns, left
+// to right. Rays are what a bot would use to see: how far it is, along
+// each of a fan of directions, to the nearest pipe or to the top or
+// bottom of the field, which end the game just the same. A ray skips
+// straight from one run to the next and checks all the rows it crosses
+// within a run with one bit scan, so it costs a few steps per pipe in
+// front of it however long it is.
+//
+class OccupancyMap
+{
+public:
+    // A unit vector; rows grow downwards
+    struct Direction
+    {
+        double m_col = 1.0;
+        double m_row = 0.0;
+    };
+
+    // A ray worked out once for any starting cell
+    struct Ray
+    {
+        Direction m_direction;
+        double m_maxDistance = 0.0;
+        double m_tPerCol = 0.0;  // Distance along the ray per column, or infinity
+        double m_tPerRow = 0.0;  // Per row, likewise
+    };
+
+    // Deleted Special Member Functions
+    //
+    OccupancyMap(void) = delete;
+    OccupancyMap(const OccupancyMap& RHS) = delete;
+    OccupancyMap(OccupancyMap&& RHS) = delete;
+    OccupancyMap& operator=(const OccupancyMap& RHS) = delete;
+    OccupancyMap& operator=(OccupancyMap&& RHS) = delete;
+
+    // Constructor
+    //
+    OccupancyMap(const int width, const int height);
+
+    // Destructor
+    //
+    ~OccupancyMap(void) = default;
+
+    // Build
+    // Marks the cells Pipe::isHit reports for the state's pipes.
+    //
+    void build(const GameState& state);
+
+    // Occupied
+    // Rows above and below the field count as occupied, since leaving it
+    // ends the game; columns outside it are empty.
+    //
+    [[nodiscard]] bool occupied(const int row, const int col) const;
+
+    // Cast Ray
+    // From the centre of the given cell, the distance in cells to where
+    // the ray enters the first occupied cell, or its maxDistance if it
+    // meets none that close. Zero if the cell itself is occupied.
+    //
+    [[nodiscard]] double castRay(const int row, const int col, const Ray& ray) const;
+
+    // Cast Rays
+    // castRay for each ray, into distances. The runs on either side of
+    // the start are found once for the whole fan.
+    //
+    void castRays(const int row, const int col, const std::vector<Ray>& rays, double* distances) const;
+
+    // Prepare Ray
+    //
+    [[nodiscard]] static Ray prepareRay(const Direction& direction, const double maxDistance);
+
+    // Fan
+    // count rays spread evenly from straight up, through straight ahead,
+    // to straight down.
+    //
+    [[nodiscard]] static std::vector<Ray> fan(const int count, const double maxDistance);
+
+private:
+    // Columns [m_first, m_last] all hold the same cells
+    struct ColumnRun
+    {
+        int m_first = 0;
+        int m_last = 0;
+    };
+
+    // The index of the first run that ends at or right of the column, and
+    // the number that begin at or left of it
+    void findRuns(const int col, size_t& ahead, size_t& behind) const;
+
+    // castRay once the start is known to be empty, from findRuns
+    [[nodiscard]] double castFrom(const int row, const int col, const Ray& ray, const size_t ahead, const size_t behind) const;
+
+    // First occupied cell in [first, last] of a column, searching down
+    // from first or up from last, or -1
+    [[nodiscard]] static int findInColumn(const uint64_t* words, const int first, const int last, const bool fromFirst);
+
+    // Private Data Variables
+    //
+    int m_width;
+    int m_height;
+    int m_wordsPerColumn;
+    std::vector<uint64_t> m_columns;  // Column c at m_columns[c * m_wordsPerColumn]
+    std::vector<ColumnRun> m_runs;    // Left to right
+};
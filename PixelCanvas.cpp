@@ -0,0 +1,463 @@
+#include "PixelCanvas.h"
+#include "Cpu.h"
+
+#include <algorithm>
+#include <immintrin.h>
+
+
+namespace
+{
+    constexpr wchar_t BLANK = L' ';
+    constexpr wchar_t UPPER_HALF_BLOCK = 0x2580;
+    constexpr wchar_t BRAILLE_BASE = 0x2800;
+
+    // Braille dot bit for each pixel of a 2x4 cell, indexed [row][col]
+    constexpr uint8_t BRAILLE_DOTS[4][2] =
+    {
+        { 0x01, 0x08 },
+        { 0x02, 0x10 },
+        { 0x04, 0x20 },
+        { 0x40, 0x80 }
+    };
+
+    // Cells handled per step: one byte of dot pattern each in a uint64_t,
+    // or eight 32-bit CHAR_INFOs in a vector
+    constexpr int CELLS_PER_STEP = 8;
+
+    // Dot patterns for every value of one byte of a pixel row, one output
+    // byte per cell the input byte covers. A Braille byte covers 4 cells
+    // (2 pixels each), a half block byte covers 8.
+    struct PatternTables
+    {
+        uint32_t m_braille[4][256] = {};
+        uint64_t m_halfBlock[2][256] = {};
+    };
+
+    constexpr PatternTables makePatternTables(void)
+    {
+        PatternTables tables;
+
+        for (int value = 0; value < 256; ++value)
+        {
+            for (int y = 0; y < 4; ++y)
+            {
+                for (int cell = 0; cell < 4; ++cell)
+                {
+                    uint32_t dots = 0;
+                    dots |= ((value >> (2 * cell)) & 1) ? BRAILLE_DOTS[y][0] : 0;
+                    dots |= ((value >> (2 * cell + 1)) & 1) ? BRAILLE_DOTS[y][1] : 0;
+                    tables.m_braille[y][value] |= dots << (8 * cell);
+                }
+            }
+
+            for (int y = 0; y < 2; ++y)
+            {
+                for (int cell = 0; cell < 8; ++cell)
+                {
+                    const uint64_t dot = ((value >> cell) & 1) ? (1ull << y) : 0;
+                    tables.m_halfBlock[y][value] |= dot << (8 * cell);
+                }
+            }
+        }
+
+        return tables;
+    }
+
+    constexpr PatternTables PATTERN_TABLES = makePatternTables();
+
+    // Glyph is base + (pattern << scale): BRAILLE_BASE + pattern, or
+    // UPPER_HALF_BLOCK + 4 * (pattern - 1)
+    struct CellStyle
+    {
+        __m256i m_base;
+        __m128i m_scale;
+        __m256i m_attributeBits;
+    };
+
+    TARGET_AVX2 CellStyle makeCellStyle(const bool braille, const WORD attributes)
+    {
+        CellStyle style;
+        style.m_base = _mm256_set1_epi32(braille ? BRAILLE_BASE : UPPER_HALF_BLOCK - 4);
+        style.m_scale = _mm_cvtsi32_si128(braille ? 0 : 2);
+        style.m_attributeBits = _mm256_set1_epi32(static_cast<int>(attributes) << 16);
+
+        return style;
+    }
+
+    // Eight patterns in the low bytes of a 128-bit value to eight CHAR_INFOs
+    TARGET_AVX2 void storeCells(const CellStyle& style, CHAR_INFO* destination, const __m128i patterns)
+    {
+        const __m256i pattern = _mm256_cvtepu8_epi32(patterns);
+        const __m256i glyphs = _mm256_add_epi32(_mm256_sll_epi32(pattern, style.m_scale), style.m_base);
+        const __m256i filled = _mm256_or_si256(glyphs, style.m_attributeBits);
+        const __m256i empty = _mm256_cmpeq_epi32(pattern, _mm256_setzero_si256());
+        const __m256i blank = _mm256_set1_epi32(BLANK);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), _mm256_blendv_epi8(filled, blank, empty));
+    }
+}
+
+
+// Constructor
+//
+PixelCanvas::PixelCanvas(const Mode mode, const int widthCells, const int heightCells)
+: m_mode(mode),
+  m_widthCells(widthCells),
+  m_heightCells(heightCells),
+  m_cellWidth(mode == Mode::BRAILLE ? 2 : 1),
+  m_cellHeight(mode == Mode::BRAILLE ? 4 : 2),
+  m_wordsPerRow(0),
+  m_useAVX2(Cpu::hasAVX2()),
+  m_bits({})
+{
+    m_wordsPerRow = ((m_widthCells * m_cellWidth) + 63) / 64;
+    m_bits.resize(static_cast<size_t>(m_wordsPerRow) * m_heightCells * m_cellHeight);
+}
+
+
+// Clear
+//
+void PixelCanvas::clear(void)
+{
+    std::fill(m_bits.begin(), m_bits.end(), 0);
+}
+
+
+// Fill Rectangle
+// Whole words in the middle of a span are set in one store each.
+//
+void PixelCanvas::fillRectangle(const int left, const int top, const int right, const int bottom)
+{
+    const int x0 = std::max(left, 0);
+    const int x1 = std::min(right, m_widthCells * m_cellWidth);
+    const int y0 = std::max(top, 0);
+    const int y1 = std::min(bottom, m_heightCells * m_cellHeight);
+
+    if (x0 >= x1 || y0 >= y1)
+    {
+        return;
+    }
+
+    const int firstWord = x0 / 64;
+    const int lastWord = (x1 - 1) / 64;
+    const uint64_t firstMask = ~0ull << (x0 % 64);
+    const uint64_t lastMask = ~0ull >> (63 - ((x1 - 1) % 64));
+
+    for (int y = y0; y < y1; ++y)
+    {
+        uint64_t* row = m_bits.data() + (static_cast<size_t>(y) * m_wordsPerRow);
+
+        if (firstWord == lastWord)
+        {
+            row[firstWord] |= firstMask & lastMask;
+            continue;
+        }
+
+        row[firstWord] |= firstMask;
+
+        for (int word = firstWord + 1; word < lastWord; ++word)
+        {
+            row[word] = ~0ull;
+        }
+
+        row[lastWord] |= lastMask;
+    }
+}
+
+
+// Pack
+//
+void PixelCanvas::pack(std::vector<CHAR_INFO>& buffer, const WORD attributes) const
+{
+    const int stepCols = (m_widthCells / CELLS_PER_STEP) * CELLS_PER_STEP;
+    const size_t wordsPerCellRow = static_cast<size_t>(m_wordsPerRow) * m_cellHeight;
+
+    for (int row = 0; row < m_heightCells; ++row)
+    {
+        CHAR_INFO* cells = buffer.data() + (static_cast<size_t>(row) * m_widthCells);
+
+        // Pipes are vertical bands, so most rows of cells have the same
+        // pixels as the row above and can copy its glyphs
+        if (row > 0)
+        {
+            const uint64_t* pixels = m_bits.data() + (row * wordsPerCellRow);
+
+            if (std::equal(pixels, pixels + wordsPerCellRow, pixels - wordsPerCellRow))
+            {
+                std::copy(cells - m_widthCells, cells, cells);
+                continue;
+            }
+        }
+
+        if (m_useAVX2)
+        {
+            this->packAVX2(cells, attributes, stepCols, row);
+        }
+        else
+        {
+            this->packScalar(cells, attributes, stepCols, row);
+        }
+
+        // The last few columns when the width is not a multiple of 8
+        for (int col = stepCols; col < m_widthCells; ++col)
+        {
+            const uint8_t pattern = this->cellPattern(row, col);
+
+            cells[col].Char.UnicodeChar = this->glyph(pattern);
+            cells[col].Attributes = (pattern == 0) ? 0 : attributes;
+        }
+    }
+}
+
+
+// Rectangle Pattern
+//
+uint8_t PixelCanvas::rectanglePattern(
+    const int cellRow,
+    const int cellCol,
+    const int left,
+    const int top,
+    const int right,
+    const int bottom) const
+{
+    uint8_t pattern = 0;
+
+    for (int y = 0; y < m_cellHeight; ++y)
+    {
+        for (int x = 0; x < m_cellWidth; ++x)
+        {
+            const int pixelX = (cellCol * m_cellWidth) + x;
+            const int pixelY = (cellRow * m_cellHeight) + y;
+
+            if (pixelX >= left && pixelX < right && pixelY >= top && pixelY < bottom)
+            {
+                pattern |= (m_mode == Mode::BRAILLE) ? BRAILLE_DOTS[y][x] : static_cast<uint8_t>(1 << y);
+            }
+        }
+    }
+
+    return pattern;
+}
+
+
+// Glyph
+// Half blocks: 1 upper, 2 lower, 3 full, which are 0x2580, 0x2584 and
+// 0x2588. Braille patterns map straight onto the block at 0x2800.
+//
+wchar_t PixelCanvas::glyph(const uint8_t pattern) const
+{
+    if (pattern == 0)
+    {
+        return BLANK;
+    }
+
+    if (m_mode == Mode::BRAILLE)
+    {
+        return static_cast<wchar_t>(BRAILLE_BASE + pattern);
+    }
+
+    return static_cast<wchar_t>(UPPER_HALF_BLOCK + (4 * (pattern - 1)));
+}
+
+
+// Cell Width
+// Accessor for m_cellWidth
+//
+int PixelCanvas::cellWidth(void) const
+{
+    return m_cellWidth;
+}
+
+
+// Cell Height
+// Accessor for m_cellHeight
+//
+int PixelCanvas::cellHeight(void) const
+{
+    return m_cellHeight;
+}
+
+
+// Force Scalar
+//
+void PixelCanvas::forceScalar(const bool scalar)
+{
+    m_useAVX2 = !scalar && Cpu::hasAVX2();
+}
+
+
+// Patterns
+// Dot patterns of the eight cells from col, one byte each.
+//
+inline uint64_t PixelCanvas::patterns(const int row, const int col) const
+{
+    auto pixelBytes = [this](const int y) -> const uint8_t*
+    {
+        return reinterpret_cast<const uint8_t*>(m_bits.data() + (static_cast<size_t>(y) * m_wordsPerRow));
+    };
+
+    const int firstY = row * m_cellHeight;
+    uint64_t patterns = 0;
+
+    if (m_mode == Mode::BRAILLE)
+    {
+        // Eight cells are 16 pixels, starting on a byte boundary
+        const int byte = col / 4;
+
+        for (int y = 0; y < 4; ++y)
+        {
+            const uint8_t* bytes = pixelBytes(firstY + y);
+            patterns |= PATTERN_TABLES.m_braille[y][bytes[byte]];
+            patterns |= static_cast<uint64_t>(PATTERN_TABLES.m_braille[y][bytes[byte + 1]]) << 32;
+        }
+    }
+    else
+    {
+        // Eight cells are 8 pixels
+        const int byte = col / 8;
+        patterns |= PATTERN_TABLES.m_halfBlock[0][pixelBytes(firstY)[byte]];
+        patterns |= PATTERN_TABLES.m_halfBlock[1][pixelBytes(firstY + 1)[byte]];
+    }
+
+    return patterns;
+}
+
+
+// Pack Scalar
+// Patterns come eight cells at a time from the tables; glyphs one by one.
+//
+void PixelCanvas::packScalar(CHAR_INFO* cells, const WORD attributes, const int lastCol, const int row) const
+{
+    for (int col = 0; col < lastCol; col += CELLS_PER_STEP)
+    {
+        const uint64_t patterns = this->patterns(row, col);
+
+        for (int cell = 0; cell < CELLS_PER_STEP; ++cell)
+        {
+            const uint8_t pattern = static_cast<uint8_t>(patterns >> (8 * cell));
+
+            cells[col + cell].Char.UnicodeChar = this->glyph(pattern);
+            cells[col + cell].Attributes = (pattern == 0) ? 0 : attributes;
+        }
+    }
+}
+
+
+// Pack AVX2
+// 32 cells per step, one per byte lane: each lane picks its cell's pixel
+// byte out of a broadcast row word with a shuffle and tests its own bits,
+// giving the dot pattern with no table. The patterns are then widened to
+// 32-bit lanes and turned into glyph and attributes, one CHAR_INFO each.
+// Empty runs, most of the field, are plain stores of blanks.
+//
+TARGET_AVX2 void PixelCanvas::packAVX2(CHAR_INFO* cells, const WORD attributes, const int lastCol, const int row) const
+{
+    static_assert(sizeof(CHAR_INFO) == 4);
+
+    const bool braille = (m_mode == Mode::BRAILLE);
+    const __m256i blank = _mm256_set1_epi32(BLANK);
+    const CellStyle style = makeCellStyle(braille, attributes);
+
+    // Which byte of the row word each lane's pixels are in, and which bits
+    // of that byte are its left (or only) and right pixels
+    const __m256i laneBytes = braille
+        ? _mm256_setr_epi8(
+            0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+            4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7)
+        : _mm256_setr_epi8(
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i leftBits = braille
+        ? _mm256_set1_epi32(0x40100401)
+        : _mm256_set1_epi64x(0x8040201008040201ll);
+    const __m256i rightBits = _mm256_set1_epi32(static_cast<int>(0x80200802));
+
+    __m256i leftDots[4];
+    __m256i rightDots[4];
+    const uint64_t* pixelRows[4] = {};
+
+    for (int y = 0; y < m_cellHeight; ++y)
+    {
+        leftDots[y] = _mm256_set1_epi8(static_cast<char>(braille ? BRAILLE_DOTS[y][0] : (1 << y)));
+        rightDots[y] = _mm256_set1_epi8(static_cast<char>(braille ? BRAILLE_DOTS[y][1] : 0));
+        pixelRows[y] = m_bits.data() + (static_cast<size_t>((row * m_cellHeight) + y) * m_wordsPerRow);
+    }
+
+    // A group may run past lastCol; the padding bits of the last word are
+    // clear and only whole steps of 8 inside lastCol are stored
+    for (int col = 0; col < lastCol; col += 32)
+    {
+        const int bit = col * m_cellWidth;
+        const int steps = std::min(32, lastCol - col) / CELLS_PER_STEP;
+        uint64_t words[4] = {};
+        uint64_t any = 0;
+
+        for (int y = 0; y < m_cellHeight; ++y)
+        {
+            // Half block cells are one bit each, so 32 cells are half a word
+            words[y] = pixelRows[y][bit / 64] >> (bit % 64);
+            any |= braille ? words[y] : static_cast<uint32_t>(words[y]);
+        }
+
+        if (any == 0)
+        {
+            for (int step = 0; step < steps; ++step)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(cells + col + (step * CELLS_PER_STEP)), blank);
+            }
+
+            continue;
+        }
+
+        __m256i patterns = _mm256_setzero_si256();
+
+        for (int y = 0; y < m_cellHeight; ++y)
+        {
+            const __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi64x(static_cast<long long>(words[y])), laneBytes);
+            const __m256i left = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, leftBits), leftBits);
+            const __m256i right = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, rightBits), rightBits);
+
+            patterns = _mm256_or_si256(patterns, _mm256_and_si256(left, leftDots[y]));
+            patterns = _mm256_or_si256(patterns, _mm256_and_si256(right, rightDots[y]));
+        }
+
+        const __m128i halves[2] = { _mm256_castsi256_si128(patterns), _mm256_extracti128_si256(patterns, 1) };
+
+        for (int step = 0; step < steps; ++step)
+        {
+            const __m128i half = halves[step / 2];
+            storeCells(style, cells + col + (step * CELLS_PER_STEP), (step % 2) ? _mm_srli_si128(half, 8) : half);
+        }
+    }
+}
+
+
+// Cell Pattern
+//
+uint8_t PixelCanvas::cellPattern(const int row, const int col) const
+{
+    uint8_t pattern = 0;
+
+    for (int y = 0; y < m_cellHeight; ++y)
+    {
+        for (int x = 0; x < m_cellWidth; ++x)
+        {
+            if (this->pixel((col * m_cellWidth) + x, (row * m_cellHeight) + y))
+            {
+                pattern |= (m_mode == Mode::BRAILLE) ? BRAILLE_DOTS[y][x] : static_cast<uint8_t>(1 << y);
+            }
+        }
+    }
+
+    return pattern;
+}
+
+
+// Pixel
+//
+bool PixelCanvas::pixel(const int x, const int y) const
+{
+    const uint64_t word = m_bits[(static_cast<size_t>(y) * m_wordsPerRow) + (x / 64)];
+
+    return ((word >> (x % 64)) & 1) != 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <windows.h>
+
+#include <cstdint>
+#include <vector>
+
+
+// PixelCanvas
+// A one bit per pixel drawing surface at a multiple of the console's cell
+// resolution: 1x2 pixels per cell shown as half blocks, or 2x4 shown as
+// Braille dots. Each pixel row is a run of 64-bit words, bit 0 leftmost,
+// so pack() can look up the dots of eight cells at a time.
+//
+class PixelCanvas
+{
+public:
+    enum class Mode
+    {
+        HALF_BLOCK = 0,
+        BRAILLE    = 1
+    };
+
+    // Deleted Special Member Functions
+    //
+    PixelCanvas(void) = delete;
+    PixelCanvas(const PixelCanvas& RHS) = delete;
+    PixelCanvas(PixelCanvas&& RHS) = delete;
+    PixelCanvas& operator=(const PixelCanvas& RHS) = delete;
+    PixelCanvas& operator=(PixelCanvas&& RHS) = delete;
+
+    // Constructor
+    //
+    PixelCanvas(const Mode mode, const int widthCells, const int heightCells);
+
+    // Destructor
+    //
+    ~PixelCanvas(void) = default;
+
+    void clear(void);
+
+    // Fill Rectangle
+    // Pixel coordinates, right and bottom exclusive. Clipped to the canvas.
+    //
+    void fillRectangle(const int left, const int top, const int right, const int bottom);
+
+    // Pack
+    // Writes every cell of the buffer: empty cells become blank, the rest
+    // become glyphs with the given attributes.
+    //
+    void pack(std::vector<CHAR_INFO>& buffer, const WORD attributes) const;
+
+    // Rectangle Pattern
+    // The dots a pixel rectangle covers within one cell, in glyph order.
+    //
+    [[nodiscard]] uint8_t rectanglePattern(
+        const int cellRow,
+        const int cellCol,
+        const int left,
+        const int top,
+        const int right,
+        const int bottom) const;
+
+    // Glyph for a cell's dot pattern, or a space for none
+    //
+    [[nodiscard]] wchar_t glyph(const uint8_t pattern) const;
+
+    [[nodiscard]] int cellWidth(void) const;
+    [[nodiscard]] int cellHeight(void) const;
+
+    // Pick the portable kernel even where AVX2 is available
+    //
+    void forceScalar(const bool scalar);
+
+private:
+    void packScalar(CHAR_INFO* cells, const WORD attributes, const int lastCol, const int row) const;
+    void packAVX2(CHAR_INFO* cells, const WORD attributes, const int lastCol, const int row) const;
+    [[nodiscard]] uint64_t patterns(const int row, const int col) const;
+    [[nodiscard]] uint8_t cellPattern(const int row, const int col) const;
+    [[nodiscard]] bool pixel(const int x, const int y) const;
+
+    // Private Data Variables
+    //
+    Mode m_mode;
+    int m_widthCells;
+    int m_heightCells;
+    int m_cellWidth;
+    int m_cellHeight;
+    int m_wordsPerRow;
+    bool m_useAVX2;
+    std::vector<uint64_t> m_bits;
+};
@@ -0,0 +1,183 @@
+#include "Replay.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+
+
+namespace
+{
+    constexpr uint32_t REPLAY_MAGIC = 0x50524246; // "FBRP"
+    constexpr uint32_t REPLAY_VERSION = 1;
+
+    struct ReplayHeader
+    {
+        uint32_t m_magic = REPLAY_MAGIC;
+        uint32_t m_version = REPLAY_VERSION;
+        uint32_t m_stateSize = sizeof(GameState);
+        uint32_t m_parametersSize = sizeof(GameParameters);
+        uint64_t m_frameCount = 0;
+    };
+}
+
+
+// Constructor
+//
+Replay::Replay(std::pmr::memory_resource* resource)
+: m_initialState(),
+  m_parameters(),
+  m_frames(resource)
+{
+}
+
+
+// Begin
+// Starts a fresh recording from the given state.
+//
+void Replay::begin(const GameState& initialState, const GameParameters& parameters)
+{
+    constexpr size_t frameReserveSize = 60 * 1024;
+
+    m_initialState = initialState;
+    m_parameters = parameters;
+    m_frames.clear();
+    m_frames.reserve(frameReserveSize);
+}
+
+
+// Record
+//
+void Replay::record(const double deltaTime, const bool jump)
+{
+    ReplayFrame frame;
+    frame.m_deltaTime = deltaTime;
+    frame.m_jump = jump;
+    m_frames.push_back(frame);
+}
+
+
+// Save
+//
+bool Replay::save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        std::cout << "Unable to open replay file for writing: " << path << std::endl;
+
+        return false;
+    }
+
+    ReplayHeader header;
+    header.m_frameCount = m_frames.size();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&m_parameters), sizeof(m_parameters));
+    file.write(reinterpret_cast<const char*>(&m_initialState), sizeof(m_initialState));
+    file.write(reinterpret_cast<const char*>(m_frames.data()), m_frames.size() * sizeof(ReplayFrame));
+
+    return static_cast<bool>(file);
+}
+
+
+// Load
+//
+bool Replay::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        std::cout << "Unable to open replay file: " << path << std::endl;
+
+        return false;
+    }
+
+    ReplayHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+    if (!file
+        || header.m_magic != REPLAY_MAGIC
+        || header.m_version != REPLAY_VERSION
+        || header.m_stateSize != sizeof(GameState)
+        || header.m_parametersSize != sizeof(GameParameters))
+    {
+        std::cout << "Not a replay from this build: " << path << std::endl;
+
+        return false;
+    }
+
+    file.read(reinterpret_cast<char*>(&m_parameters), sizeof(m_parameters));
+    file.read(reinterpret_cast<char*>(&m_initialState), sizeof(m_initialState));
+
+    // Levels are not recorded, and a pointer from another run means nothing
+    m_parameters.m_levelPipes = nullptr;
+    m_parameters.m_levelPipeCount = 0;
+
+    if (file
+        && (m_parameters.m_width < GameParameters::m_minWidth
+         || m_parameters.m_width > GameParameters::m_maxSize
+         || m_parameters.m_height < GameParameters::m_minHeight
+         || m_parameters.m_height > GameParameters::m_maxSize))
+    {
+        std::cout << "Replay has an unplayable field size: " << path << std::endl;
+        m_frames.clear();
+
+        return false;
+    }
+
+    // Only as many frames as the file holds, before allocating for them
+    const std::streamoff framesStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff frameBytes = file.tellg() - framesStart;
+    file.seekg(framesStart);
+
+    if (!file || frameBytes < 0 || header.m_frameCount > static_cast<uint64_t>(frameBytes) / sizeof(ReplayFrame))
+    {
+        std::cout << "Replay file is truncated: " << path << std::endl;
+        m_frames.clear();
+
+        return false;
+    }
+
+    m_frames.resize(header.m_frameCount);
+    file.read(reinterpret_cast<char*>(m_frames.data()), m_frames.size() * sizeof(ReplayFrame));
+
+    if (!file)
+    {
+        std::cout << "Replay file is truncated: " << path << std::endl;
+        m_frames.clear();
+
+        return false;
+    }
+
+    return true;
+}
+
+
+// Initial State
+// Accessor for m_initialState
+//
+const GameState& Replay::initialState(void) const
+{
+    return m_initialState;
+}
+
+
+// Parameters
+// Accessor for m_parameters
+//
+const GameParameters& Replay::parameters(void) const
+{
+    return m_parameters;
+}
+
+
+// Frames
+// Accessor for m_frames
+//
+const std::pmr::vector<ReplayFrame>& Replay::frames(void) const
+{
+    return m_frames;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+
+struct ReplayFrame
+{
+    double m_deltaTime = 0.0;
+    bool m_jump = false;
+};
+
+
+// Replay
+// A recorded game: the starting state plus the frame time and jump input
+// of every frame. Re-running Simulation::step over the frames reproduces
+// the game exactly.
+//
+class Replay
+{
+public:
+    Replay(void) = default;
+    ~Replay(void) = default;
+
+    // Frames come from the given resource, such as an episode's arena
+    //
+    explicit Replay(std::pmr::memory_resource* resource);
+
+    void begin(const GameState& initialState, const GameParameters& parameters);
+    void record(const double deltaTime, const bool jump);
+
+    [[nodiscard]] bool save(const std::string& path) const;
+    [[nodiscard]] bool load(const std::string& path);
+
+    [[nodiscard]] const GameState& initialState(void) const;
+    [[nodiscard]] const GameParameters& parameters(void) const;
+    [[nodiscard]] const std::pmr::vector<ReplayFrame>& frames(void) const;
+
+private:
+    GameState m_initialState;
+    GameParameters m_parameters;
+    std::pmr::vector<ReplayFrame> m_frames;
+};
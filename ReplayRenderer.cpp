@@ -0,0 +1,496 @@
+#include "ReplayRenderer.h"
+
+#include "BitmapFont.h"
+#include "Scene.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <io.h>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+
+namespace
+{
+    struct Color
+    {
+        uint8_t m_red;
+        uint8_t m_green;
+        uint8_t m_blue;
+    };
+
+    // The 16 console colours, indexed by the low/high nibble of Attributes
+    constexpr Color PALETTE[16] =
+    {
+        {  12,  12,  12 }, {   0,  55, 218 }, {  19, 161,  14 }, {  58, 150, 221 },
+        { 197,  15,  31 }, { 136,  23, 152 }, { 193, 156,   0 }, { 204, 204, 204 },
+        { 118, 118, 118 }, {  59, 120, 255 }, {  22, 198,  12 }, {  97, 214, 214 },
+        { 231,  72,  86 }, { 180,   0, 158 }, { 249, 241, 165 }, { 242, 242, 242 }
+    };
+
+    void appendBigEndian(std::vector<uint8_t>& output, const uint32_t value)
+    {
+        output.push_back(static_cast<uint8_t>(value >> 24));
+        output.push_back(static_cast<uint8_t>(value >> 16));
+        output.push_back(static_cast<uint8_t>(value >> 8));
+        output.push_back(static_cast<uint8_t>(value));
+    }
+
+    uint32_t crc32(const uint8_t* data, const size_t length)
+    {
+        static const std::array<uint32_t, 256> table = []()
+        {
+            std::array<uint32_t, 256> result = {};
+
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t value = i;
+
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+                }
+
+                result[i] = value;
+            }
+
+            return result;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    // Appends length, type, data and CRC; data must already follow the type
+    void finishPNGChunk(std::vector<uint8_t>& output, const size_t lengthOffset)
+    {
+        const size_t typeOffset = lengthOffset + 4;
+        const uint32_t length = static_cast<uint32_t>(output.size() - typeOffset - 4);
+
+        output[lengthOffset + 0] = static_cast<uint8_t>(length >> 24);
+        output[lengthOffset + 1] = static_cast<uint8_t>(length >> 16);
+        output[lengthOffset + 2] = static_cast<uint8_t>(length >> 8);
+        output[lengthOffset + 3] = static_cast<uint8_t>(length);
+
+        appendBigEndian(output, crc32(output.data() + typeOffset, output.size() - typeOffset));
+    }
+
+    size_t beginPNGChunk(std::vector<uint8_t>& output, const char* type)
+    {
+        const size_t lengthOffset = output.size();
+        output.insert(output.end(), 4, 0);
+        output.insert(output.end(), type, type + 4);
+
+        return lengthOffset;
+    }
+}
+
+
+// Constructor
+//
+ReplayRenderer::ReplayRenderer(const Replay& replay, const ImageFormat format, const int threadCount)
+: m_replay(replay),
+  m_format(format),
+  m_threadCount(std::max(threadCount, 1)),
+  m_imageWidth(replay.parameters().m_width * m_cellWidth),
+  m_imageHeight(replay.parameters().m_height * m_cellHeight),
+  m_chunkStates({})
+{
+    // Nothing else to do
+}
+
+
+// Render
+//
+bool ReplayRenderer::render(const std::string& output)
+{
+    using namespace std::chrono;
+
+    const bool streaming = (output == "-");
+    std::ostream& log = streaming ? std::cerr : std::cout;
+
+    if (m_replay.frames().empty())
+    {
+        log << "The replay has no frames." << std::endl;
+
+        return false;
+    }
+
+    if (streaming)
+    {
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+
+    const auto start = high_resolution_clock::now();
+
+    this->computeChunkStates();
+
+    const int chunkCount = static_cast<int>(m_chunkStates.size());
+    const int slotCount = m_threadCount * 2;
+    std::vector<Chunk> slots(slotCount);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    int nextChunk = 0;
+    int writtenChunks = 0;
+    bool failed = false;
+
+    auto worker = [&](void)
+    {
+        Scratch scratch;
+        scratch.m_cells.resize(m_replay.parameters().m_width * m_replay.parameters().m_height);
+        scratch.m_pixels.resize(static_cast<size_t>(m_imageWidth) * m_imageHeight * 3);
+
+        while (true)
+        {
+            int chunkIndex = 0;
+
+            {
+                // Never run more than slotCount chunks ahead of the writer
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() {
+                    return failed || nextChunk >= chunkCount || nextChunk < writtenChunks + slotCount; });
+
+                if (failed || nextChunk >= chunkCount)
+                {
+                    return;
+                }
+
+                chunkIndex = nextChunk++;
+            }
+
+            Chunk& chunk = slots[chunkIndex % slotCount];
+            this->renderChunk(chunkIndex, scratch, chunk);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                chunk.m_ready = true;
+            }
+
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(m_threadCount);
+
+    for (int i = 0; i < m_threadCount; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+
+    // Write chunks in order as they complete
+    for (int chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+    {
+        Chunk& chunk = slots[chunkIndex % slotCount];
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return chunk.m_ready; });
+        }
+
+        const bool written = this->writeChunk(chunkIndex, chunk, output);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk.m_ready = false;
+            ++writtenChunks;
+            failed = !written;
+        }
+
+        changed.notify_all();
+
+        if (!written)
+        {
+            log << "Unable to write frames for chunk " << chunkIndex << "." << std::endl;
+            break;
+        }
+    }
+
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+
+    const double seconds = duration<double>(high_resolution_clock::now() - start).count();
+    const size_t frameCount = m_replay.frames().size();
+
+    log << "Rendered " << frameCount << " frames (" << m_imageWidth << "x" << m_imageHeight
+        << ") on " << m_threadCount << " threads in " << seconds << " s: "
+        << (frameCount / seconds) << " frames/second" << std::endl;
+
+    return !failed;
+}
+
+
+// Compute Chunk States
+// A quick sequential pass that keeps only the state at the start of each
+// frame range, so workers can start anywhere without holding every frame.
+//
+void ReplayRenderer::computeChunkStates(void)
+{
+    const auto& frames = m_replay.frames();
+    const auto& parameters = m_replay.parameters();
+
+    m_chunkStates.clear();
+    m_chunkStates.reserve((frames.size() + m_framesPerChunk - 1) / m_framesPerChunk);
+
+    GameState state = m_replay.initialState();
+
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+        if (i % m_framesPerChunk == 0)
+        {
+            m_chunkStates.push_back(state);
+        }
+
+        Simulation::step(state, parameters, frames[i].m_jump, frames[i].m_deltaTime);
+    }
+}
+
+
+// Render Chunk
+//
+void ReplayRenderer::renderChunk(const int chunkIndex, Scratch& scratch, Chunk& chunk) const
+{
+    const auto& frames = m_replay.frames();
+    const auto& parameters = m_replay.parameters();
+    const size_t first = static_cast<size_t>(chunkIndex) * m_framesPerChunk;
+    const size_t last = std::min(first + m_framesPerChunk, frames.size());
+
+    chunk.m_bytes.clear();
+    chunk.m_frameEnds.clear();
+
+    GameState state = m_chunkStates[chunkIndex];
+
+    for (size_t i = first; i < last; ++i)
+    {
+        const ReplayFrame& frame = frames[i];
+        Simulation::step(state, parameters, frame.m_jump, frame.m_deltaTime);
+
+        std::for_each(
+            scratch.m_cells.begin(),
+            scratch.m_cells.end(),
+            [](auto& charInfo) {
+                charInfo.Attributes = 0;
+                charInfo.Char.UnicodeChar = L' '; });
+
+        const double fps = frame.m_deltaTime > 0.0 ? 1.0 / frame.m_deltaTime : 0.0;
+        Scene::compose(state, parameters, fps, scratch.m_cells);
+
+        this->rasterize(scratch.m_cells, scratch.m_pixels);
+
+        if (m_format == ImageFormat::PNG)
+        {
+            this->encodePNG(scratch.m_pixels, chunk.m_bytes);
+        }
+        else
+        {
+            this->encodePPM(scratch.m_pixels, chunk.m_bytes);
+        }
+
+        chunk.m_frameEnds.push_back(chunk.m_bytes.size());
+    }
+}
+
+
+// Rasterize
+// Cells to 24-bit RGB. Font rows are doubled to get the usual 1:2 cell.
+//
+void ReplayRenderer::rasterize(const std::vector<CHAR_INFO>& cells, std::vector<uint8_t>& pixels) const
+{
+    const int columns = m_replay.parameters().m_width;
+    const int rows = m_replay.parameters().m_height;
+    const size_t stride = static_cast<size_t>(m_imageWidth) * 3;
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int col = 0; col < columns; ++col)
+        {
+            const CHAR_INFO& cell = cells[Utilities::computeTheOffset(row, col, columns)];
+            const Color& foreground = PALETTE[cell.Attributes & 0xF];
+            const Color& background = PALETTE[(cell.Attributes >> 4) & 0xF];
+            const uint8_t* glyph = BitmapFont::glyph(cell.Char.UnicodeChar);
+
+            uint8_t* cellOrigin = pixels.data()
+                + (static_cast<size_t>(row) * m_cellHeight * stride)
+                + (static_cast<size_t>(col) * m_cellWidth * 3);
+
+            for (int y = 0; y < m_cellHeight; ++y)
+            {
+                const uint8_t bits = glyph[y * BitmapFont::m_glyphHeight / m_cellHeight];
+                uint8_t* pixel = cellOrigin + (y * stride);
+
+                for (int x = 0; x < m_cellWidth; ++x, pixel += 3)
+                {
+                    const Color& color = ((bits >> x) & 1) ? foreground : background;
+                    pixel[0] = color.m_red;
+                    pixel[1] = color.m_green;
+                    pixel[2] = color.m_blue;
+                }
+            }
+        }
+    }
+}
+
+
+// Encode PPM
+//
+void ReplayRenderer::encodePPM(const std::vector<uint8_t>& pixels, std::vector<uint8_t>& output) const
+{
+    const std::string header = "P6\n" + std::to_string(m_imageWidth) + " "
+                             + std::to_string(m_imageHeight) + "\n255\n";
+
+    output.insert(output.end(), header.begin(), header.end());
+    output.insert(output.end(), pixels.begin(), pixels.end());
+}
+
+
+// Encode PNG
+// Uses stored (uncompressed) deflate blocks, which keeps the encoder tiny
+// and as fast as a copy. Pipe the stream to an encoder for small files.
+//
+void ReplayRenderer::encodePNG(const std::vector<uint8_t>& pixels, std::vector<uint8_t>& output) const
+{
+    constexpr uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    constexpr size_t maxBlockLength = 65535;
+
+    const size_t stride = static_cast<size_t>(m_imageWidth) * 3;
+    const size_t rawSize = (stride + 1) * m_imageHeight;
+    output.reserve(output.size() + rawSize + ((rawSize / maxBlockLength) + 1) * 5 + 128);
+
+    output.insert(output.end(), std::begin(signature), std::end(signature));
+
+    // Header
+    size_t chunkOffset = beginPNGChunk(output, "IHDR");
+    appendBigEndian(output, static_cast<uint32_t>(m_imageWidth));
+    appendBigEndian(output, static_cast<uint32_t>(m_imageHeight));
+    output.push_back(8); // Bit depth
+    output.push_back(2); // Truecolour
+    output.push_back(0); // Deflate
+    output.push_back(0); // Adaptive filtering
+    output.push_back(0); // No interlace
+    finishPNGChunk(output, chunkOffset);
+
+    // Image data
+    chunkOffset = beginPNGChunk(output, "IDAT");
+    output.push_back(0x78);
+    output.push_back(0x01);
+
+    uint32_t adlerLow = 1;
+    uint32_t adlerHigh = 0;
+    size_t blockOffset = 0;
+    size_t blockLength = 0;
+    bool blockOpen = false;
+
+    auto closeBlock = [&](const bool final)
+    {
+        output[blockOffset + 0] = final ? 1 : 0;
+        output[blockOffset + 1] = static_cast<uint8_t>(blockLength);
+        output[blockOffset + 2] = static_cast<uint8_t>(blockLength >> 8);
+        output[blockOffset + 3] = static_cast<uint8_t>(~blockLength);
+        output[blockOffset + 4] = static_cast<uint8_t>(~blockLength >> 8);
+    };
+
+    auto append = [&](const uint8_t* data, size_t length)
+    {
+        while (length > 0)
+        {
+            if (!blockOpen || blockLength == maxBlockLength)
+            {
+                if (blockOpen)
+                {
+                    closeBlock(false);
+                }
+
+                blockOffset = output.size();
+                blockLength = 0;
+                blockOpen = true;
+                output.insert(output.end(), 5, 0);
+            }
+
+            const size_t take = std::min(length, maxBlockLength - blockLength);
+
+            // Adler-32, reducing only every 5552 bytes as zlib does
+            for (size_t done = 0; done < take;)
+            {
+                const size_t run = std::min<size_t>(take - done, 5552);
+
+                for (size_t i = done; i < done + run; ++i)
+                {
+                    adlerLow += data[i];
+                    adlerHigh += adlerLow;
+                }
+
+                adlerLow %= 65521;
+                adlerHigh %= 65521;
+                done += run;
+            }
+
+            output.insert(output.end(), data, data + take);
+            blockLength += take;
+            data += take;
+            length -= take;
+        }
+    };
+
+    constexpr uint8_t noFilter = 0;
+
+    for (int row = 0; row < m_imageHeight; ++row)
+    {
+        append(&noFilter, 1);
+        append(pixels.data() + (row * stride), stride);
+    }
+
+    closeBlock(true);
+    appendBigEndian(output, (adlerHigh << 16) | adlerLow);
+    finishPNGChunk(output, chunkOffset);
+
+    // End
+    chunkOffset = beginPNGChunk(output, "IEND");
+    finishPNGChunk(output, chunkOffset);
+}
+
+
+// Write Chunk
+//
+bool ReplayRenderer::writeChunk(const int chunkIndex, const Chunk& chunk, const std::string& output) const
+{
+    if (output == "-")
+    {
+        return std::fwrite(chunk.m_bytes.data(), 1, chunk.m_bytes.size(), stdout) == chunk.m_bytes.size();
+    }
+
+    const char* extension = (m_format == ImageFormat::PNG) ? ".png" : ".ppm";
+    size_t frameStart = 0;
+
+    for (size_t i = 0; i < chunk.m_frameEnds.size(); ++i)
+    {
+        char number[16];
+        std::snprintf(number, sizeof(number), "%06zu", (static_cast<size_t>(chunkIndex) * m_framesPerChunk) + i);
+
+        std::ofstream file(output + number + extension, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(chunk.m_bytes.data() + frameStart), chunk.m_frameEnds[i] - frameStart);
+
+        if (!file)
+        {
+            return false;
+        }
+
+        frameStart = chunk.m_frameEnds[i];
+    }
+
+    return true;
+}
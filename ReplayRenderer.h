@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ConsoleEngine.hpp"
+#include "Replay.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// ReplayRenderer
+// Turns a replay into an image sequence without a terminal. Frames are
+// cut into fixed ranges that worker threads render in parallel; a single
+// writer streams the encoded frames out in order.
+//
+class ReplayRenderer
+{
+public:
+    enum class ImageFormat
+    {
+        PPM = 0,
+        PNG = 1
+    };
+
+    // Deleted Special Member Functions
+    //
+    ReplayRenderer(void) = delete;
+    ReplayRenderer(const ReplayRenderer& RHS) = delete;
+    ReplayRenderer(ReplayRenderer&& RHS) = delete;
+    ReplayRenderer& operator=(const ReplayRenderer& RHS) = delete;
+    ReplayRenderer& operator=(ReplayRenderer&& RHS) = delete;
+
+    // Constructor
+    //
+    ReplayRenderer(const Replay& replay, const ImageFormat format, const int threadCount);
+
+    // Destructor
+    //
+    ~ReplayRenderer(void) = default;
+
+    // Render
+    // Writes <output>000000.ppm, <output>000001.ppm, ... or, when output is
+    // "-", one concatenated stream on stdout (e.g. for ffmpeg image2pipe).
+    //
+    [[nodiscard]] bool render(const std::string& output);
+
+private:
+    static constexpr int m_cellWidth = 8;
+    static constexpr int m_cellHeight = 16;
+    static constexpr int m_framesPerChunk = 32;
+
+    // Per-worker buffers, reused for every frame the worker renders
+    //
+    struct Scratch
+    {
+        std::vector<CHAR_INFO> m_cells;
+        std::vector<uint8_t> m_pixels;
+    };
+
+    // Encoded output of one frame range
+    //
+    struct Chunk
+    {
+        std::vector<uint8_t> m_bytes;
+        std::vector<size_t> m_frameEnds;
+        bool m_ready = false;
+    };
+
+    void computeChunkStates(void);
+    void renderChunk(const int chunkIndex, Scratch& scratch, Chunk& chunk) const;
+    void rasterize(const std::vector<CHAR_INFO>& cells, std::vector<uint8_t>& pixels) const;
+    void encodePPM(const std::vector<uint8_t>& pixels, std::vector<uint8_t>& output) const;
+    void encodePNG(const std::vector<uint8_t>& pixels, std::vector<uint8_t>& output) const;
+    [[nodiscard]] bool writeChunk(const int chunkIndex, const Chunk& chunk, const std::string& output) const;
+
+    const Replay& m_replay;
+    const ImageFormat m_format;
+    const int m_threadCount;
+    const int m_imageWidth;
+    const int m_imageHeight;
+    std::vector<GameState> m_chunkStates;
+};
@@ -0,0 +1,139 @@
+#include "RewindHistory.h"
+#include "Trace.h"
+
+#include <cmath>
+
+
+// Constructor
+// One keyframe more than the seconds strictly need, so a full window is
+// still kept while the newest interval is only partly played.
+//
+RewindHistory::RewindHistory(const double tickSeconds, const double seconds)
+: m_tickSeconds(tickSeconds),
+  m_oldestTick(0),
+  m_nextTick(0),
+  m_keyframes(),
+  m_jumps(),
+  m_interval(m_keyframeInterval),
+  m_intervalIndex(-1)
+{
+    const double ticks = std::ceil(seconds / tickSeconds);
+    const size_t intervals = static_cast<size_t>(std::ceil(ticks / m_keyframeInterval)) + 1;
+
+    m_keyframes.resize(intervals);
+    m_jumps.resize(((intervals * m_keyframeInterval) + 63) / 64);
+}
+
+
+// Clear
+//
+void RewindHistory::clear(void)
+{
+    m_oldestTick = 0;
+    m_nextTick = 0;
+    m_intervalIndex = -1;
+}
+
+
+// Record
+//
+void RewindHistory::record(const GameState& before, const bool jump)
+{
+    const uint64_t tick = m_nextTick;
+    const uint64_t ringTicks = m_keyframes.size() * m_keyframeInterval;
+
+    if (tick % m_keyframeInterval == 0)
+    {
+        // Starting an interval over the oldest one drops it
+        if (tick - m_oldestTick >= ringTicks)
+        {
+            m_oldestTick += m_keyframeInterval;
+        }
+
+        m_keyframes[(tick / m_keyframeInterval) % m_keyframes.size()] = before;
+    }
+
+    const uint64_t bit = tick % ringTicks;
+    const uint64_t mask = 1ull << (bit % 64);
+    m_jumps[bit / 64] = jump ? (m_jumps[bit / 64] | mask) : (m_jumps[bit / 64] & ~mask);
+
+    ++m_nextTick;
+
+    // Its later states may now be out of date
+    if (m_intervalIndex == static_cast<int64_t>(tick / m_keyframeInterval))
+    {
+        m_intervalIndex = -1;
+    }
+}
+
+
+// Step Back
+//
+bool RewindHistory::stepBack(GameState& state, const GameParameters& parameters)
+{
+    if (m_nextTick <= m_oldestTick)
+    {
+        return false;
+    }
+
+    const uint64_t tick = m_nextTick - 1;
+    const int64_t interval = static_cast<int64_t>(tick / m_keyframeInterval);
+    const uint64_t intervalStart = static_cast<uint64_t>(interval) * m_keyframeInterval;
+
+    // Played forwards once per interval, then read backwards
+    if (interval != m_intervalIndex)
+    {
+        TRACE_SCOPE("RewindHistory::rebuildInterval");
+
+        m_interval[0] = m_keyframes[static_cast<size_t>(interval) % m_keyframes.size()];
+
+        for (uint64_t i = 1; i <= tick - intervalStart; ++i)
+        {
+            m_interval[i] = m_interval[i - 1];
+            Simulation::step(m_interval[i], parameters, this->jumped(intervalStart + i - 1), m_tickSeconds);
+        }
+
+        m_intervalIndex = interval;
+    }
+
+    state = m_interval[tick - intervalStart];
+    m_nextTick = tick;
+
+    return true;
+}
+
+
+// Seconds Available
+//
+double RewindHistory::secondsAvailable(void) const
+{
+    return static_cast<double>(m_nextTick - m_oldestTick) * m_tickSeconds;
+}
+
+
+// Memory Bytes
+//
+size_t RewindHistory::memoryBytes(void) const
+{
+    return (m_keyframes.size() * sizeof(GameState))
+         + (m_jumps.size() * sizeof(uint64_t))
+         + (m_interval.size() * sizeof(GameState));
+}
+
+
+// Tick Seconds
+//
+double RewindHistory::tickSeconds(void) const
+{
+    return m_tickSeconds;
+}
+
+
+// Jumped
+//
+bool RewindHistory::jumped(const uint64_t tick) const
+{
+    const uint64_t bit = tick % (m_keyframes.size() * m_keyframeInterval);
+
+    return (m_jumps[bit / 64] >> (bit % 64)) & 1;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// RewindHistory
+// The last stretch of a fixed-tick game, kept so it can be played
+// backwards. Storing every tick's state would take sizeof(GameState) per
+// tick; instead a full state is kept once per keyframe interval, and each
+// tick in between is just its jump bit, since the simulation is
+// deterministic. Stepping back rebuilds the current interval from its
+// keyframe once into a scratch array and then walks down it, so rewinding
+// costs a copy per frame and a short re-simulation per interval. All
+// storage is sized up front; nothing allocates after construction.
+//
+class RewindHistory
+{
+public:
+    // Deleted Special Member Functions
+    //
+    RewindHistory(void) = delete;
+    RewindHistory(const RewindHistory& RHS) = delete;
+    RewindHistory(RewindHistory&& RHS) = delete;
+    RewindHistory& operator=(const RewindHistory& RHS) = delete;
+    RewindHistory& operator=(RewindHistory&& RHS) = delete;
+
+    // Constructor
+    // Keeps at least the given number of seconds.
+    //
+    RewindHistory(const double tickSeconds, const double seconds);
+
+    // Destructor
+    //
+    ~RewindHistory(void) = default;
+
+    // Forget everything, for a new game
+    //
+    void clear(void);
+
+    // Record
+    // Called with the state before each tick is played and that tick's
+    // input. Anything stepped back over is overwritten from here on.
+    //
+    void record(const GameState& before, const bool jump);
+
+    // Step Back
+    // Replaces the state with the one a tick earlier. False, leaving it
+    // alone, once at the oldest tick kept. The parameters must be the ones
+    // the ticks were played with.
+    //
+    [[nodiscard]] bool stepBack(GameState& state, const GameParameters& parameters);
+
+    // Seconds of play that can still be rewound
+    //
+    [[nodiscard]] double secondsAvailable(void) const;
+
+    // Bytes of storage held, for comparison with storing every state
+    //
+    [[nodiscard]] size_t memoryBytes(void) const;
+
+    [[nodiscard]] double tickSeconds(void) const;
+
+private:
+    static constexpr uint32_t m_keyframeInterval = 120;
+
+    [[nodiscard]] bool jumped(const uint64_t tick) const;
+
+    // Private Data Variables
+    //
+    double m_tickSeconds;
+    uint64_t m_oldestTick;              // A keyframe tick
+    uint64_t m_nextTick;                // The tick the next record() plays
+    std::vector<GameState> m_keyframes; // Interval k at m_keyframes[k % size]
+    std::vector<uint64_t> m_jumps;      // One bit per tick, a ring as long as the keyframes cover
+    std::vector<GameState> m_interval;  // The interval being rewound through, rebuilt
+    int64_t m_intervalIndex;            // Which interval m_interval holds, or -1
+};
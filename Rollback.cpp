@@ -0,0 +1,289 @@
+#include "Rollback.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstddef>
+
+
+// Size
+//
+size_t InputPacket::size(void) const
+{
+    return offsetof(InputPacket, m_jumpTicks) + (std::min<size_t>(m_jumpCount, m_maxJumps) * sizeof(uint32_t));
+}
+
+
+// Constructor
+//
+RollbackSession::RollbackSession(
+    const GameParameters& parameters,
+    const Random& course,
+    const int localPlayer,
+    const double tickSeconds)
+: m_parameters(parameters),
+  m_tickSeconds(tickSeconds),
+  m_localPlayer(localPlayer),
+  m_rivalPlayer(1 - localPlayer),
+  m_tick(0),
+  m_remoteThrough(0),
+  m_remoteAck(0),
+  m_state(),
+  m_saved(),
+  m_inputs(),
+  m_statistics()
+{
+    for (GameState& player : m_state.m_players)
+    {
+        player.m_random = course;
+        Simulation::reset(player, m_parameters);
+    }
+}
+
+
+// Can Advance
+//
+bool RollbackSession::canAdvance(void) const
+{
+    return m_tick - std::min(m_remoteThrough, m_tick) < m_window;
+}
+
+
+// Advance
+//
+void RollbackSession::advance(const bool localJump)
+{
+    if (localJump)
+    {
+        this->recordJump(m_tick, m_localPlayer);
+    }
+
+    this->simulate();
+}
+
+
+// Receive
+//
+void RollbackSession::receive(const InputPacket& packet)
+{
+    if (packet.m_tag != InputPacket::m_magic)
+    {
+        return;
+    }
+
+    m_remoteAck = std::max(m_remoteAck, packet.m_ack);
+
+    // The packet covers every rival input from our ack up to its own
+    // through, so only the part past what we already have is news
+    if (packet.m_through <= m_remoteThrough)
+    {
+        return;
+    }
+
+    uint32_t earliestMisprediction = m_tick;
+    const uint32_t jumpCount = std::min<uint32_t>(packet.m_jumpCount, InputPacket::m_maxJumps);
+
+    for (uint32_t i = 0; i < jumpCount; ++i)
+    {
+        const uint32_t jumpTick = packet.m_jumpTicks[i];
+
+        if (jumpTick < m_remoteThrough || jumpTick >= packet.m_through)
+        {
+            continue;
+        }
+
+        this->recordJump(jumpTick, m_rivalPlayer);
+
+        // Played as "no jump"
+        if (jumpTick < m_tick)
+        {
+            earliestMisprediction = std::min(earliestMisprediction, jumpTick);
+        }
+    }
+
+    m_remoteThrough = packet.m_through;
+
+    if (earliestMisprediction < m_tick)
+    {
+        this->rollback(earliestMisprediction);
+    }
+}
+
+
+// Make Packet
+//
+InputPacket RollbackSession::makePacket(void) const
+{
+    InputPacket packet;
+    packet.m_through = m_tick;
+    packet.m_ack = m_remoteThrough;
+
+    for (uint32_t tick = std::min(m_remoteAck, m_tick); tick < m_tick; ++tick)
+    {
+        if (!this->jumped(tick, m_localPlayer))
+        {
+            continue;
+        }
+
+        // Claim only as far as the jumps that fit; the rest go next time
+        if (packet.m_jumpCount == InputPacket::m_maxJumps)
+        {
+            packet.m_through = tick;
+            break;
+        }
+
+        packet.m_jumpTicks[packet.m_jumpCount++] = tick;
+    }
+
+    return packet;
+}
+
+
+// Finished
+//
+bool RollbackSession::finished(void) const
+{
+    const VersusState& confirmed = this->confirmedState();
+
+    return !confirmed.m_players[0].m_running && !confirmed.m_players[1].m_running;
+}
+
+
+// Peer Caught Up
+//
+bool RollbackSession::peerCaughtUp(void) const
+{
+    return m_remoteAck >= m_tick;
+}
+
+
+// State
+//
+const VersusState& RollbackSession::state(void) const
+{
+    return m_state;
+}
+
+
+// Local
+//
+const GameState& RollbackSession::local(void) const
+{
+    return m_state.m_players[m_localPlayer];
+}
+
+
+// Rival
+//
+const GameState& RollbackSession::rival(void) const
+{
+    return m_state.m_players[m_rivalPlayer];
+}
+
+
+// Tick
+//
+uint32_t RollbackSession::tick(void) const
+{
+    return m_tick;
+}
+
+
+// Confirmed Tick
+// Every tick before this was played with real inputs from both sides.
+//
+uint32_t RollbackSession::confirmedTick(void) const
+{
+    return std::min(m_remoteThrough, m_tick);
+}
+
+
+// Statistics
+//
+const RollbackStatistics& RollbackSession::statistics(void) const
+{
+    return m_statistics;
+}
+
+
+// Simulate
+// Saves the state before the current tick, then plays it. A player who is
+// out stays frozen so their score stops counting.
+//
+void RollbackSession::simulate(void)
+{
+    m_saved[m_tick % m_window] = m_state;
+
+    for (int player = 0; player < 2; ++player)
+    {
+        GameState& game = m_state.m_players[player];
+
+        if (game.m_running)
+        {
+            Simulation::step(game, m_parameters, this->jumped(m_tick, player), m_tickSeconds);
+        }
+    }
+
+    ++m_tick;
+}
+
+
+// Rollback
+// Replays from the state saved before the given tick up to the present.
+//
+void RollbackSession::rollback(const uint32_t tick)
+{
+    TRACE_SCOPE("RollbackSession::rollback");
+
+    const uint32_t present = m_tick;
+    const uint32_t depth = present - tick;
+
+    m_state = m_saved[tick % m_window];
+    m_tick = tick;
+
+    while (m_tick < present)
+    {
+        this->simulate();
+    }
+
+    ++m_statistics.m_rollbacks;
+    m_statistics.m_resimulatedTicks += depth;
+    m_statistics.m_deepestRollback = std::max(m_statistics.m_deepestRollback, depth);
+}
+
+
+// Record Jump
+//
+void RollbackSession::recordJump(const uint32_t tick, const int player)
+{
+    TickInputs& inputs = m_inputs[tick % m_inputHistory];
+
+    if (inputs.m_tick != tick)
+    {
+        inputs = TickInputs();
+        inputs.m_tick = tick;
+    }
+
+    inputs.m_jump[player] = true;
+}
+
+
+// Jumped
+//
+bool RollbackSession::jumped(const uint32_t tick, const int player) const
+{
+    const TickInputs& inputs = m_inputs[tick % m_inputHistory];
+
+    return inputs.m_tick == tick && inputs.m_jump[player];
+}
+
+
+// Confirmed State
+// The state before the confirmed tick. The session never runs more than
+// a window past it, so it is either current or still saved.
+//
+const VersusState& RollbackSession::confirmedState(void) const
+{
+    const uint32_t confirmed = this->confirmedTick();
+
+    return (confirmed == m_tick) ? m_state : m_saved[confirmed % m_window];
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Simulation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+// VersusState
+// Both players' games on the same course, stepped together on one fixed
+// tick. Player 0 is whichever side has the lower port.
+//
+struct VersusState
+{
+    GameState m_players[2];
+};
+
+static_assert(std::is_trivially_copyable_v<VersusState>, "VersusState must stay memcpy-able");
+
+
+// InputPacket
+// All a peer ever sends: the ticks on which it jumped since the last tick
+// we confirmed having, up to the tick it has played to. Repeating the
+// unacknowledged jumps in every packet means a lost packet costs nothing
+// but a little more rollback.
+//
+struct InputPacket
+{
+    static constexpr uint32_t m_magic = 0x504E4246; // "FBNP"
+    static constexpr int m_maxJumps = 128;
+
+    uint32_t m_tag = m_magic;
+    uint32_t m_through = 0;   // The sender's inputs for every tick before this are included
+    uint32_t m_ack = 0;       // The sender has the receiver's inputs for every tick before this
+    uint32_t m_jumpCount = 0;
+    uint32_t m_jumpTicks[m_maxJumps] = {};
+
+    // Only the used part of m_jumpTicks goes on the wire
+    [[nodiscard]] size_t size(void) const;
+};
+
+
+struct RollbackStatistics
+{
+    uint64_t m_rollbacks = 0;
+    uint64_t m_resimulatedTicks = 0;
+    uint32_t m_deepestRollback = 0;
+};
+
+
+// RollbackSession
+// Runs a versus game ahead of the peer. Local jumps apply on the tick they
+// happen; the rival is predicted not to jump. When a packet reveals a jump
+// on a tick already played, the state saved before that tick is restored
+// and the game is re-simulated to the present with the real input. Saves
+// and restores are plain copies of VersusState, so re-simulating a second
+// of play costs far less than a frame.
+//
+class RollbackSession
+{
+public:
+    // How far ahead of the peer's confirmed input we may run, in ticks.
+    // Also the deepest rollback there can ever be.
+    static constexpr uint32_t m_window = 64;
+
+    // Deleted Special Member Functions
+    //
+    RollbackSession(void) = delete;
+    RollbackSession(const RollbackSession& RHS) = delete;
+    RollbackSession(RollbackSession&& RHS) = delete;
+    RollbackSession& operator=(const RollbackSession& RHS) = delete;
+    RollbackSession& operator=(RollbackSession&& RHS) = delete;
+
+    // Constructor
+    // Both players start from the same course RNG, so both sides must be
+    // given the same one.
+    //
+    RollbackSession(
+        const GameParameters& parameters,
+        const Random& course,
+        const int localPlayer,
+        const double tickSeconds);
+
+    // Destructor
+    //
+    ~RollbackSession(void) = default;
+
+    // Can Advance
+    // False while a whole window ahead of the peer; the caller waits.
+    //
+    [[nodiscard]] bool canAdvance(void) const;
+
+    // Advance
+    // Plays one tick with the local input and the predicted rival input.
+    //
+    void advance(const bool localJump);
+
+    // Receive
+    // Takes in the peer's inputs and rolls back if any contradict what was
+    // predicted. Stale and duplicate packets are harmless.
+    //
+    void receive(const InputPacket& packet);
+
+    // Make Packet
+    // Local jumps the peer has not confirmed yet, through the current tick.
+    //
+    [[nodiscard]] InputPacket makePacket(void) const;
+
+    // Finished
+    // Both players are out on a tick whose inputs are all confirmed, so no
+    // rollback can revive either of them.
+    //
+    [[nodiscard]] bool finished(void) const;
+
+    // Peer Caught Up
+    // The peer has confirmed every local input we have played.
+    //
+    [[nodiscard]] bool peerCaughtUp(void) const;
+
+    [[nodiscard]] const VersusState& state(void) const;
+    [[nodiscard]] const GameState& local(void) const;
+    [[nodiscard]] const GameState& rival(void) const;
+    [[nodiscard]] uint32_t tick(void) const;
+    [[nodiscard]] uint32_t confirmedTick(void) const;
+    [[nodiscard]] const RollbackStatistics& statistics(void) const;
+
+private:
+    // Tick-stamped so a slot left over from an older tick reads as no jump
+    struct TickInputs
+    {
+        uint32_t m_tick = UINT32_MAX;
+        bool m_jump[2] = { false, false };
+    };
+
+    // Covers local inputs back to the peer's ack and rival inputs up to a
+    // window ahead, which together never span more than this
+    static constexpr uint32_t m_inputHistory = 4 * m_window;
+
+    void simulate(void);
+    void rollback(const uint32_t tick);
+    void recordJump(const uint32_t tick, const int player);
+    [[nodiscard]] bool jumped(const uint32_t tick, const int player) const;
+    [[nodiscard]] const VersusState& confirmedState(void) const;
+
+    // Private Data Variables
+    //
+    GameParameters m_parameters;
+    double m_tickSeconds;
+    int m_localPlayer;
+    int m_rivalPlayer;
+    uint32_t m_tick;
+    uint32_t m_remoteThrough;
+    uint32_t m_remoteAck;
+    VersusState m_state;
+    VersusState m_saved[m_window]; // m_saved[t % m_window] is the state before tick t
+    TickInputs m_inputs[m_inputHistory];
+    RollbackStatistics m_statistics;
+};
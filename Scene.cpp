@@ -0,0 +1,367 @@
+#include "Scene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+
+// Compose
+// Expects a cleared buffer of width * height cells.
+//
+void Scene::compose(
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps,
+    std::vector<CHAR_INFO>& buffer)
+{
+    // Draw Pipes to buffer
+    for (const auto& pipe : state.m_pipes)
+    {
+        Scene::drawPipe(pipe, parameters, buffer);
+    }
+
+    // Draw Bird to buffer
+    Scene::drawBird(state, parameters, buffer);
+
+    // Overlay these last
+    Scene::drawHeadsUpDisplay(state, parameters, fps, buffer);
+}
+
+
+// Compose Rows
+//
+void Scene::composeRows(
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps,
+    const int firstRow,
+    const int lastRow,
+    CHAR_INFO* rows)
+{
+    const int width = parameters.m_width;
+
+    CHAR_INFO blank;
+    blank.Attributes = 0;
+    blank.Char.UnicodeChar = L' ';
+
+    CHAR_INFO pipeCell;
+    pipeCell.Attributes = FOREGROUND_GREEN;
+    pipeCell.Char.UnicodeChar = 0x2588;
+
+    std::fill(rows, rows + (static_cast<size_t>(lastRow - firstRow) * width), blank);
+
+    // Pipes, as drawPipe paints them
+    for (const auto& pipe : state.m_pipes)
+    {
+        if (!pipe.isVisible(width))
+        {
+            continue;
+        }
+
+        const int bottomStartRow = pipe.m_gapStartRow + pipe.m_gapSize;
+
+        for (int row = firstRow; row < lastRow; ++row)
+        {
+            if (row >= pipe.m_gapStartRow && row < bottomStartRow)
+            {
+                continue;
+            }
+
+            CHAR_INFO* cells = rows + (static_cast<size_t>(row - firstRow) * width);
+            std::fill(cells + pipe.m_col, cells + pipe.m_col + pipe.m_width, pipeCell);
+
+            if (row == pipe.m_gapStartRow - 1 || row == bottomStartRow)
+            {
+                cells[std::max(pipe.m_col - 1, 0)] = pipeCell;
+                cells[pipe.m_col + pipe.m_width] = pipeCell;
+            }
+        }
+    }
+
+    // Bird
+    if (state.m_row >= firstRow && state.m_row < lastRow && state.m_col >= 0 && state.m_col < width)
+    {
+        CHAR_INFO& bird = rows[(static_cast<size_t>(state.m_row - firstRow) * width) + state.m_col];
+        bird.Attributes = 7;
+        bird.Char.UnicodeChar = 0x2588;
+    }
+
+    // HUD, clipped to the row rather than running on into the next
+    if (firstRow < 3)
+    {
+        const int fpsInt = static_cast<int>(std::ceil(fps));
+        const std::wstring lines[3] =
+        {
+            L"FPS: " + std::to_wstring(fpsInt),
+            L"Velocity: " + std::to_wstring(state.m_verticalVelocity),
+            L"Score: " + std::to_wstring(state.m_score)
+        };
+
+        for (int row = firstRow; row < std::min(lastRow, 3); ++row)
+        {
+            CHAR_INFO* cells = rows + (static_cast<size_t>(row - firstRow) * width);
+            const std::wstring& line = lines[row];
+
+            for (size_t i = 0; i < std::min(line.length(), static_cast<size_t>(width)); ++i)
+            {
+                cells[i].Attributes = 7;
+                cells[i].Char.UnicodeChar = line[i];
+            }
+        }
+    }
+}
+
+
+// Compose Tile
+// Each tile row stands for a band of field rows and is left open if any
+// of them is in a pipe's gap, so a gap stays open however far it is
+// shrunk; each pipe keeps at least one column. The bird goes in the row
+// whose band holds it, which is open whenever it is flying through a gap.
+//
+void Scene::composeTile(
+    const GameState& state,
+    const GameParameters& parameters,
+    CHAR_INFO* frame,
+    const int frameWidth,
+    const int left,
+    const int top,
+    const int width,
+    const int height)
+{
+    const int fieldWidth = parameters.m_width;
+    const int fieldHeight = parameters.m_height;
+
+    if (width <= 0 || height <= 0 || fieldWidth <= 0 || fieldHeight <= 0)
+    {
+        return;
+    }
+
+    CHAR_INFO blank;
+    blank.Attributes = 0;
+    blank.Char.UnicodeChar = L' ';
+
+    CHAR_INFO pipeCell;
+    pipeCell.Attributes = FOREGROUND_GREEN;
+    pipeCell.Char.UnicodeChar = 0x2588;
+
+    auto tileRow = [&](const int row) -> CHAR_INFO*
+    {
+        return frame + (static_cast<size_t>(top + row) * frameWidth) + left;
+    };
+
+    // Field rows [bandStart(row), bandStart(row + 1)), at least one of them
+    auto bandStart = [&](const int row)
+    {
+        return (row * fieldHeight) / height;
+    };
+
+    for (int row = 0; row < height; ++row)
+    {
+        std::fill(tileRow(row), tileRow(row) + width, blank);
+    }
+
+    for (const auto& pipe : state.m_pipes)
+    {
+        const int firstCol = std::max(pipe.m_col, 0);
+        const int lastCol = std::min(pipe.m_col + pipe.m_width, fieldWidth) - 1;
+
+        if (!pipe.isVisible(fieldWidth) || lastCol < firstCol)
+        {
+            continue;
+        }
+
+        const int firstTileCol = (firstCol * width) / fieldWidth;
+        const int lastTileCol = (lastCol * width) / fieldWidth;
+        const int bottomStartRow = pipe.m_gapStartRow + pipe.m_gapSize;
+
+        for (int row = 0; row < height; ++row)
+        {
+            const int firstFieldRow = bandStart(row);
+            const int endFieldRow = std::max(bandStart(row + 1), firstFieldRow + 1);
+
+            if (firstFieldRow < bottomStartRow && endFieldRow > pipe.m_gapStartRow)
+            {
+                continue;
+            }
+
+            std::fill(tileRow(row) + firstTileCol, tileRow(row) + lastTileCol + 1, pipeCell);
+        }
+    }
+
+    if (state.m_row >= 0 && state.m_row < fieldHeight && state.m_col >= 0 && state.m_col < fieldWidth)
+    {
+        // The last row whose band starts at or above the bird
+        const int birdRow = std::min((((state.m_row + 1) * height) - 1) / fieldHeight, height - 1);
+
+        CHAR_INFO& bird = tileRow(birdRow)[(state.m_col * width) / fieldWidth];
+        bird.Attributes = state.m_running ? 7 : (FOREGROUND_RED | FOREGROUND_INTENSITY);
+        bird.Char.UnicodeChar = 0x2588;
+    }
+
+    const std::wstring score = std::to_wstring(state.m_score);
+
+    for (size_t i = 0; i < std::min(score.length(), static_cast<size_t>(width)); ++i)
+    {
+        tileRow(0)[i].Attributes = 7;
+        tileRow(0)[i].Char.UnicodeChar = score[i];
+    }
+}
+
+
+// Compose High Resolution
+//
+void Scene::composeHighResolution(
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps,
+    PixelCanvas& canvas,
+    std::vector<CHAR_INFO>& buffer)
+{
+    const int cellWidth = canvas.cellWidth();
+    const int cellHeight = canvas.cellHeight();
+
+    canvas.clear();
+
+    // Pipes, with the same shape and visibility as the cell renderer
+    for (const auto& pipe : state.m_pipes)
+    {
+        if (!pipe.isVisible(parameters.m_width))
+        {
+            continue;
+        }
+
+        const int left = static_cast<int>(std::round(pipe.m_colPosition * cellWidth));
+        const int right = left + (pipe.m_width * cellWidth);
+        const int gapTop = pipe.m_gapStartRow * cellHeight;
+        const int gapBottom = (pipe.m_gapStartRow + pipe.m_gapSize) * cellHeight;
+
+        canvas.fillRectangle(left, 0, right, gapTop);
+        canvas.fillRectangle(left, gapBottom, right, parameters.m_height * cellHeight);
+
+        // The lip either side of the gap
+        canvas.fillRectangle(left - cellWidth, gapTop - cellHeight, right + cellWidth, gapTop);
+        canvas.fillRectangle(left - cellWidth, gapBottom, right + cellWidth, gapBottom + cellHeight);
+    }
+
+    canvas.pack(buffer, FOREGROUND_GREEN);
+
+    // Bird: one cell in size, but placed to the pixel row, so it can
+    // straddle two cells. Drawn over the pipes in its own colour.
+    const int birdLeft = state.m_col * cellWidth;
+    const int birdTop = static_cast<int>(std::round(state.m_rowDouble * cellHeight));
+    const int birdRight = birdLeft + cellWidth;
+    const int birdBottom = birdTop + cellHeight;
+    const int firstRow = std::max(birdTop / cellHeight, 0);
+    const int lastRow = std::min((birdBottom - 1) / cellHeight, parameters.m_height - 1);
+
+    for (int row = firstRow; row <= lastRow && birdBottom > 0; ++row)
+    {
+        const int col = state.m_col;
+        const uint8_t pattern = canvas.rectanglePattern(row, col, birdLeft, birdTop, birdRight, birdBottom);
+
+        if (pattern != 0 && col >= 0 && col < parameters.m_width)
+        {
+            CHAR_INFO& cell = buffer.at(Utilities::computeTheOffset(row, col, parameters.m_width));
+            cell.Attributes = 7;
+            cell.Char.UnicodeChar = canvas.glyph(pattern);
+        }
+    }
+
+    // Overlay these last
+    Scene::drawHeadsUpDisplay(state, parameters, fps, buffer);
+}
+
+
+// Draw Pipe
+//
+void Scene::drawPipe(const Pipe& pipe, const GameParameters& parameters, std::vector<CHAR_INFO>& buffer)
+{
+    if (!pipe.isVisible(parameters.m_width))
+    {
+        return; // Do not draw this
+    }
+
+    CHAR_INFO charInfo;
+    charInfo.Attributes = FOREGROUND_GREEN;
+    charInfo.Char.UnicodeChar = 0x2588;
+
+    const int bottomStartRow = pipe.m_gapStartRow + pipe.m_gapSize;
+
+    for (int row = 0; row < parameters.m_height; ++row)
+    {
+        if (row >= pipe.m_gapStartRow && row < bottomStartRow)
+        {
+            continue; // The gap
+        }
+
+        const int offset = Utilities::computeTheOffset(row, pipe.m_col, parameters.m_width);
+
+        for (int col = 0; col < pipe.m_width; ++col)
+        {
+            buffer.at(offset + col) = charInfo;
+        }
+
+        // The lip either side of the gap
+        if (row == pipe.m_gapStartRow - 1 || row == bottomStartRow)
+        {
+            buffer.at(offset - 1) = charInfo;
+            buffer.at(offset + pipe.m_width) = charInfo;
+        }
+    }
+}
+
+
+// Draw Bird
+//
+void Scene::drawBird(const GameState& state, const GameParameters& parameters, std::vector<CHAR_INFO>& buffer)
+{
+    CHAR_INFO bird;
+    bird.Attributes = 7;
+    bird.Char.UnicodeChar = 0x2588;
+
+    const int offset = Utilities::computeTheOffset(state.m_row, state.m_col, parameters.m_width);
+
+    if (offset >= 0 && offset < buffer.size())
+    {
+        buffer.at(offset) = bird;
+    }
+}
+
+
+// Draw Rival
+// The other bird in a versus game, in red. Nothing once it has left the
+// field.
+//
+void Scene::drawRival(const GameState& rival, const GameParameters& parameters, std::vector<CHAR_INFO>& buffer)
+{
+    if (rival.m_row < 0 || rival.m_row >= parameters.m_height)
+    {
+        return;
+    }
+
+    CHAR_INFO bird;
+    bird.Attributes = FOREGROUND_RED | FOREGROUND_INTENSITY;
+    bird.Char.UnicodeChar = 0x2588;
+
+    buffer.at(Utilities::computeTheOffset(rival.m_row, rival.m_col, parameters.m_width)) = bird;
+}
+
+
+// Draw Heads Up Display
+// FPS, velocity and score in the top left corner.
+//
+void Scene::drawHeadsUpDisplay(
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps,
+    std::vector<CHAR_INFO>& buffer)
+{
+    const int fpsInt = static_cast<int>(std::ceil(fps));
+    const std::wstring fpsStr = L"FPS: " + std::to_wstring(fpsInt);
+    const std::wstring velStr = L"Velocity: " + std::to_wstring(state.m_verticalVelocity);
+    const std::wstring scoreStr = L"Score: " + std::to_wstring(state.m_score);
+
+    Utilities::drawStringToBuffer(buffer, parameters.m_width, fpsStr, 0, 0);
+    Utilities::drawStringToBuffer(buffer, parameters.m_width, velStr, 1, 0);
+    Utilities::drawStringToBuffer(buffer, parameters.m_width, scoreStr, 2, 0);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ConsoleEngine.hpp"
+#include "PixelCanvas.h"
+#include "Simulation.h"
+
+
+// Scene
+// Paints a game state into a cell buffer. Shared by the live game and
+// the offline tools so they all produce the same frames.
+//
+namespace Scene
+{
+    void compose(
+        const GameState& state,
+        const GameParameters& parameters,
+        const double fps,
+        std::vector<CHAR_INFO>& buffer);
+
+    // Compose Rows
+    // Rows [firstRow, lastRow) of the frame compose() draws, written to a
+    // block of just those rows. Clears the block first, so bands of one
+    // frame can be composed independently and in any order.
+    //
+    void composeRows(
+        const GameState& state,
+        const GameParameters& parameters,
+        const double fps,
+        const int firstRow,
+        const int lastRow,
+        CHAR_INFO* rows);
+
+    // Compose Tile
+    // The whole field scaled down into a width x height rectangle of a
+    // larger frame, for a grid of many games: pipes, the bird (red once
+    // dead) and the score in the corner. Writes every cell of the
+    // rectangle and nothing outside it.
+    //
+    void composeTile(
+        const GameState& state,
+        const GameParameters& parameters,
+        CHAR_INFO* frame,
+        const int frameWidth,
+        const int left,
+        const int top,
+        const int width,
+        const int height);
+
+    // Compose High Resolution
+    // Pipes and bird at their fractional positions on the canvas, packed
+    // into half block or Braille glyphs. Writes every cell of the buffer.
+    //
+    void composeHighResolution(
+        const GameState& state,
+        const GameParameters& parameters,
+        const double fps,
+        PixelCanvas& canvas,
+        std::vector<CHAR_INFO>& buffer);
+
+    void drawPipe(const Pipe& pipe, const GameParameters& parameters, std::vector<CHAR_INFO>& buffer);
+    void drawBird(const GameState& state, const GameParameters& parameters, std::vector<CHAR_INFO>& buffer);
+    void drawRival(const GameState& rival, const GameParameters& parameters, std::vector<CHAR_INFO>& buffer);
+    void drawHeadsUpDisplay(
+        const GameState& state,
+        const GameParameters& parameters,
+        const double fps,
+        std::vector<CHAR_INFO>& buffer);
+}
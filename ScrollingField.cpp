@@ -0,0 +1,243 @@
+#include "ScrollingField.h"
+#include "Scene.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+namespace
+{
+    // A column is empty, a pipe body or a pipe lip, and the rest of its
+    // contents follow from the gap. Packed as kind | gap start << 8 | gap
+    // size << 16. A column more than one pipe touches, which only tightly
+    // spaced levels have, is mixed and has no signature of its own.
+    constexpr uint32_t EMPTY_COLUMN = 0;
+    constexpr uint32_t BODY_COLUMN = 1;
+    constexpr uint32_t LIP_COLUMN = 2;
+    constexpr uint32_t MIXED_COLUMN = 3;
+    constexpr uint32_t UNDRAWN_COLUMN = UINT32_MAX;
+
+    uint32_t signature(const uint32_t kind, const Pipe& pipe)
+    {
+        return kind
+             | (static_cast<uint32_t>(pipe.m_gapStartRow & 0xFF) << 8)
+             | (static_cast<uint32_t>(pipe.m_gapSize & 0xFF) << 16);
+    }
+
+    CHAR_INFO pipeCell(void)
+    {
+        CHAR_INFO cell;
+        cell.Attributes = FOREGROUND_GREEN;
+        cell.Char.UnicodeChar = 0x2588;
+
+        return cell;
+    }
+
+    CHAR_INFO blankCell(void)
+    {
+        CHAR_INFO cell;
+        cell.Attributes = 0;
+        cell.Char.UnicodeChar = L' ';
+
+        return cell;
+    }
+}
+
+
+// Constructor
+//
+ScrollingField::ScrollingField(const int width, const int height)
+: m_width(width),
+  m_height(height),
+  m_offset(0),
+  m_cells(static_cast<size_t>(width) * height, blankCell()),
+  m_drawn(width, UNDRAWN_COLUMN),
+  m_wanted(width, EMPTY_COLUMN),
+  m_previousPipes(),
+  m_hasPrevious(false),
+  m_rasterizedColumns(0)
+{
+}
+
+
+// Compose
+//
+void ScrollingField::compose(
+    const GameState& state,
+    const GameParameters& parameters,
+    const double fps,
+    std::vector<CHAR_INFO>& buffer)
+{
+    TRACE_SCOPE("ScrollingField::compose");
+
+    // Scroll first, so columns that only moved already match
+    const int scroll = this->scrollSincePreviousFrame(state);
+
+    if (scroll > 0 && scroll < m_width)
+    {
+        m_offset = (m_offset + scroll) % m_width;
+    }
+
+    this->updateSignatures(state);
+
+    for (int col = 0; col < m_width; ++col)
+    {
+        const int ringCol = (m_offset + col) % m_width;
+
+        if (m_wanted[col] == MIXED_COLUMN)
+        {
+            this->rasterizeMixedColumn(ringCol, col, state);
+        }
+        else if (m_drawn[ringCol] != m_wanted[col])
+        {
+            this->rasterizeColumn(ringCol, m_wanted[col]);
+        }
+    }
+
+    // Present
+    for (int row = 0; row < m_height; ++row)
+    {
+        const auto ringRow = m_cells.begin() + (static_cast<ptrdiff_t>(row) * m_width);
+        const auto bufferRow = buffer.begin() + (static_cast<ptrdiff_t>(row) * m_width);
+        const auto wrapped = std::copy(ringRow + m_offset, ringRow + m_width, bufferRow);
+        std::copy(ringRow, ringRow + m_offset, wrapped);
+    }
+
+    std::copy(std::begin(state.m_pipes), std::end(state.m_pipes), std::begin(m_previousPipes));
+    m_hasPrevious = true;
+
+    Scene::drawBird(state, parameters, buffer);
+    Scene::drawHeadsUpDisplay(state, parameters, fps, buffer);
+}
+
+
+// Rasterized Columns
+//
+uint64_t ScrollingField::rasterizedColumns(void) const
+{
+    return m_rasterizedColumns;
+}
+
+
+// Scroll Since Previous Frame
+// Pipes share one speed, so the front pipe's move is everyone's. If it
+// has been recycled the new front pipe was second last frame. Only a
+// guess: pipes round to cells separately, and any column it gets wrong is
+// caught by its signature.
+//
+int ScrollingField::scrollSincePreviousFrame(const GameState& state) const
+{
+    if (!m_hasPrevious)
+    {
+        return 0;
+    }
+
+    const bool recycled = state.m_pipes[0].m_colPosition > m_previousPipes[0].m_colPosition;
+
+    return m_previousPipes[recycled ? 1 : 0].m_col - state.m_pipes[0].m_col;
+}
+
+
+// Update Signatures
+//
+void ScrollingField::updateSignatures(const GameState& state)
+{
+    std::fill(m_wanted.begin(), m_wanted.end(), EMPTY_COLUMN);
+
+    auto want = [this](const int col, const uint32_t columnSignature)
+    {
+        m_wanted[col] = (m_wanted[col] == EMPTY_COLUMN) ? columnSignature : MIXED_COLUMN;
+    };
+
+    for (const Pipe& pipe : state.m_pipes)
+    {
+        if (!pipe.isVisible(m_width))
+        {
+            continue;
+        }
+
+        for (int col = pipe.m_col; col < pipe.m_col + pipe.m_width; ++col)
+        {
+            want(col, signature(BODY_COLUMN, pipe));
+        }
+
+        for (const int col : { pipe.m_col - 1, pipe.m_col + pipe.m_width })
+        {
+            if (col >= 0 && col < m_width)
+            {
+                want(col, signature(LIP_COLUMN, pipe));
+            }
+        }
+    }
+}
+
+
+// Rasterize Column
+//
+void ScrollingField::rasterizeColumn(const int ringCol, const uint32_t columnSignature)
+{
+    const uint32_t kind = columnSignature & 0xFF;
+    const int gapStart = static_cast<int>((columnSignature >> 8) & 0xFF);
+    const int gapEnd = gapStart + static_cast<int>((columnSignature >> 16) & 0xFF);
+
+    for (int row = 0; row < m_height; ++row)
+    {
+        bool filled = false;
+
+        if (kind == BODY_COLUMN)
+        {
+            filled = (row < gapStart || row >= gapEnd);
+        }
+        else if (kind == LIP_COLUMN)
+        {
+            filled = (row == gapStart - 1 || row == gapEnd);
+        }
+
+        m_cells[(static_cast<size_t>(row) * m_width) + ringCol] = filled ? pipeCell() : blankCell();
+    }
+
+    m_drawn[ringCol] = columnSignature;
+    ++m_rasterizedColumns;
+}
+
+
+// Rasterize Mixed Column
+// Paints every pipe touching the column over blanks, as Scene::compose
+// would. Left undrawn, so it is painted afresh every frame it stays mixed.
+//
+void ScrollingField::rasterizeMixedColumn(const int ringCol, const int col, const GameState& state)
+{
+    for (int row = 0; row < m_height; ++row)
+    {
+        m_cells[(static_cast<size_t>(row) * m_width) + ringCol] = blankCell();
+    }
+
+    for (const Pipe& pipe : state.m_pipes)
+    {
+        const bool body = (col >= pipe.m_col && col < pipe.m_col + pipe.m_width);
+        const bool lip = (col == pipe.m_col - 1 || col == pipe.m_col + pipe.m_width);
+
+        if (!pipe.isVisible(m_width) || (!body && !lip))
+        {
+            continue;
+        }
+
+        const int gapEnd = pipe.m_gapStartRow + pipe.m_gapSize;
+
+        for (int row = 0; row < m_height; ++row)
+        {
+            const bool filled = body
+                ? (row < pipe.m_gapStartRow || row >= gapEnd)
+                : (row == pipe.m_gapStartRow - 1 || row == gapEnd);
+
+            if (filled)
+            {
+                m_cells[(static_cast<size_t>(row) * m_width) + ringCol] = pipeCell();
+            }
+        }
+    }
+
+    m_drawn[ringCol] = UNDRAWN_COLUMN;
+    ++m_rasterizedColumns;
+}
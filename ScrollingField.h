@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ConsoleEngine.hpp"
+#include "Simulation.h"
+
+#include <cstdint>
+#include <vector>
+
+
+// ScrollingField
+// The pipe layer of the cell renderer, kept between frames. The world only
+// moves sideways, so when the pipes step left the field turns a ring
+// offset instead of redrawing, and only columns whose contents changed
+// (newly exposed ones, pipes appearing or leaving) are rasterized, at
+// O(height) each. Every column's contents follow from a small signature,
+// so comparing signatures finds those columns exactly and the result is
+// always the frame Scene::compose would draw. Columns two pipes share, in
+// tightly spaced levels, are painted from the pipes every frame instead.
+//
+class ScrollingField
+{
+public:
+    // Deleted Special Member Functions
+    //
+    ScrollingField(void) = delete;
+    ScrollingField(const ScrollingField& RHS) = delete;
+    ScrollingField(ScrollingField&& RHS) = delete;
+    ScrollingField& operator=(const ScrollingField& RHS) = delete;
+    ScrollingField& operator=(ScrollingField&& RHS) = delete;
+
+    // Constructor
+    //
+    ScrollingField(const int width, const int height);
+
+    // Destructor
+    //
+    ~ScrollingField(void) = default;
+
+    // Compose
+    // Same frame as Scene::compose, bird and HUD included. Writes every
+    // cell of the buffer.
+    //
+    void compose(
+        const GameState& state,
+        const GameParameters& parameters,
+        const double fps,
+        std::vector<CHAR_INFO>& buffer);
+
+    // Columns rasterized since construction
+    //
+    [[nodiscard]] uint64_t rasterizedColumns(void) const;
+
+private:
+    [[nodiscard]] int scrollSincePreviousFrame(const GameState& state) const;
+    void updateSignatures(const GameState& state);
+    void rasterizeColumn(const int ringCol, const uint32_t signature);
+    void rasterizeMixedColumn(const int ringCol, const int col, const GameState& state);
+
+    // Private Data Variables
+    //
+    int m_width;
+    int m_height;
+    int m_offset;                      // Ring column shown at screen column 0
+    std::vector<CHAR_INFO> m_cells;    // Row-major ring, so each row presents in two copies
+    std::vector<uint32_t> m_drawn;     // Signature of each ring column as rasterized
+    std::vector<uint32_t> m_wanted;    // Signature each screen column needs this frame
+    Pipe m_previousPipes[GameState::m_pipeCount];
+    bool m_hasPrevious;
+    uint64_t m_rasterizedColumns;
+};
@@ -0,0 +1,237 @@
+#include "Simulation.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+    // The next pipe of the course: the level's, or a random one
+    LevelPipe nextCoursePipe(GameState& state, const GameParameters& parameters)
+    {
+        if (parameters.m_levelPipes != nullptr)
+        {
+            const LevelPipe pipe = parameters.m_levelPipes[state.m_levelCursor];
+            state.m_levelCursor = (state.m_levelCursor + 1) % parameters.m_levelPipeCount;
+
+            return pipe;
+        }
+
+        LevelPipe pipe;
+
+        // Choose random gap size:  [5, 10]
+        pipe.m_gapSize = static_cast<uint8_t>(state.m_random.range(5, 10));
+
+        // Choose random gap start: [2, 18], kept on screen for short fields
+        const int maxGapStart = std::clamp(parameters.m_height - 12, 2, 18);
+        pipe.m_gapStartRow = static_cast<uint8_t>(state.m_random.range(2, maxGapStart));
+
+        return pipe;
+    }
+
+    // Gives the pipe its gap and places it at the given column. A level's
+    // gaps are only checked here, as they come on, so opening one never
+    // has to read it all.
+    void layoutPipe(Pipe& pipe, const LevelPipe& coursePipe, const GameParameters& parameters, const double colPosition)
+    {
+        pipe = Pipe();
+        pipe.m_velocity = parameters.m_pipeVelocity;
+        pipe.m_colPosition = colPosition;
+        pipe.m_col = static_cast<int>(std::round(pipe.m_colPosition));
+        pipe.m_gapStartRow = std::min<int>(coursePipe.m_gapStartRow, parameters.m_height - 1);
+        pipe.m_gapSize = std::max<int>(coursePipe.m_gapSize, 1);
+    }
+}
+
+
+// Seed
+// Scrambles the seed so that nearby seeds give unrelated courses.
+//
+void Random::seed(const uint64_t seed)
+{
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z = z ^ (z >> 31);
+
+    // Xorshift must never hold a zero state
+    m_state = (z == 0) ? 0x9E3779B97F4A7C15ull : z;
+}
+
+
+// Next
+//
+uint32_t Random::next(void)
+{
+    m_state ^= m_state >> 12;
+    m_state ^= m_state << 25;
+    m_state ^= m_state >> 27;
+
+    return static_cast<uint32_t>((m_state * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+
+// Range
+// Returns a number in [low, high].
+//
+int Random::range(const int low, const int high)
+{
+    const uint32_t span = static_cast<uint32_t>(high - low + 1);
+
+    return low + static_cast<int>(this->next() % span);
+}
+
+
+// Update Pipe position
+//
+void Pipe::updatePosition(const double deltaTime)
+{
+    m_colPosition -= (m_velocity * deltaTime);
+    m_col = static_cast<int>(std::round(m_colPosition));
+}
+
+
+// Is Visible
+// Pipes are only drawn, and only collide, once fully on screen.
+//
+bool Pipe::isVisible(const int width) const
+{
+    return m_col >= 0 && m_col < width - m_width;
+}
+
+
+// Is Hit
+// Whether the given cell lies inside the body of this pipe.
+//
+bool Pipe::isHit(const int row, const int col, const int width, const int height) const
+{
+    if (!this->isVisible(width))
+    {
+        return false;
+    }
+
+    if (col < m_col || col >= m_col + m_width)
+    {
+        return false;
+    }
+
+    return (row >= 0 && row < m_gapStartRow)
+        || (row >= m_gapStartRow + m_gapSize && row < height);
+}
+
+
+// Reset
+// Starts a new course. The RNG carries on from wherever it was; a level
+// starts again from its first pipe.
+//
+void Simulation::reset(GameState& state, const GameParameters& parameters)
+{
+    state.m_score = 0;
+    state.m_verticalVelocity = 0.0;
+    state.m_row = parameters.m_height / 2;
+    state.m_rowDouble = static_cast<double>(state.m_row);
+    state.m_col = 25;
+    state.m_running = true;
+    state.m_levelCursor = 0;
+
+    // The first pipe's spacing is the run-up, which is always the same
+    double colPosition = parameters.m_width / 2;
+
+    for (int i = 0; i < GameState::m_pipeCount; ++i)
+    {
+        const LevelPipe coursePipe = nextCoursePipe(state, parameters);
+
+        if (i > 0)
+        {
+            colPosition += Pipe::m_width + coursePipe.m_spacing;
+        }
+
+        layoutPipe(state.m_pipes[i], coursePipe, parameters, colPosition);
+    }
+}
+
+
+// Step
+// Advances the game by deltaTime seconds.
+//
+void Simulation::step(
+    GameState& state,
+    const GameParameters& parameters,
+    const bool jump,
+    const double deltaTime)
+{
+    // Physics
+    if (jump)
+    {
+        state.m_verticalVelocity = parameters.m_jumpVelocity;
+    }
+
+    state.m_verticalVelocity = state.m_verticalVelocity - (parameters.m_gravity * deltaTime);
+
+    state.m_rowDouble -= (state.m_verticalVelocity * deltaTime);
+
+    state.m_row = static_cast<int>(std::round(state.m_rowDouble));
+
+    if (state.m_row < 0 || state.m_row >= parameters.m_height)
+    {
+        state.m_running = false;
+    }
+
+    for (Pipe& pipe : state.m_pipes)
+    {
+        pipe.updatePosition(deltaTime);
+
+        // Update score
+        if ((!pipe.m_scoreTracked) && ((pipe.m_col + pipe.m_width) <= state.m_col))
+        {
+            ++state.m_score;
+            pipe.m_scoreTracked = true;
+        }
+    }
+
+    // Recycle pipes that are out of the field of view. Pipes stay ordered
+    // left to right, so only the front one can have left.
+    while (state.m_pipes[0].m_col < 5)
+    {
+        TRACE_SCOPE("Simulation::recyclePipe");
+
+        for (int i = 1; i < GameState::m_pipeCount; ++i)
+        {
+            state.m_pipes[i - 1] = state.m_pipes[i];
+        }
+
+        // Append a new one
+        const Pipe& lastPipe = state.m_pipes[GameState::m_pipeCount - 2];
+        const LevelPipe coursePipe = nextCoursePipe(state, parameters);
+        const double colPosition = lastPipe.m_col + Pipe::m_width + coursePipe.m_spacing;
+        layoutPipe(state.m_pipes[GameState::m_pipeCount - 1], coursePipe, parameters, colPosition);
+    }
+
+    // Collisions
+    for (const Pipe& pipe : state.m_pipes)
+    {
+        if (pipe.isHit(state.m_row, state.m_col, parameters.m_width, parameters.m_height))
+        {
+            state.m_running = false;
+            break;
+        }
+    }
+}
+
+
+// Next Pipe
+// The first pipe the bird has not yet cleared.
+//
+const Pipe* Simulation::nextPipe(const GameState& state)
+{
+    for (const Pipe& pipe : state.m_pipes)
+    {
+        if (pipe.m_col + pipe.m_width > state.m_col)
+        {
+            return &pipe;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+// Random
+// Small xorshift generator. It lives inside the game state so that the
+// course can be cloned and restored along with everything else.
+//
+struct Random
+{
+    uint64_t m_state = 0x9E3779B97F4A7C15ull;
+
+    void seed(const uint64_t seed);
+    [[nodiscard]] uint32_t next(void);
+    [[nodiscard]] int range(const int low, const int high); // Inclusive
+};
+
+
+struct Pipe
+{
+    static constexpr int m_width = 4;
+    double m_velocity = 15.0; // units per second
+
+    double m_colPosition = 0.0;
+
+    int m_col = 0;         // Will decrement from the end each second
+    int m_gapSize = 10;    // How big the gap is
+    int m_gapStartRow = 7; // The row the gap starts relative to the top
+    bool m_scoreTracked = false;
+
+    void updatePosition(const double deltaTime);
+    [[nodiscard]] bool isVisible(const int width) const;
+    [[nodiscard]] bool isHit(const int row, const int col, const int width, const int height) const;
+};
+
+
+// LevelPipe
+// One pipe of an authored course, as stored in a level file: its gap, and
+// the open columns between it and the pipe before.
+//
+struct LevelPipe
+{
+    uint8_t m_gapStartRow = 7;
+    uint8_t m_gapSize = 10;
+    uint16_t m_spacing = 15;
+};
+
+static_assert(sizeof(LevelPipe) == 4, "LevelPipe is the level file's record");
+
+
+struct GameParameters
+{
+    // Pipes spawn from the middle, so leave room for a few of them
+    static constexpr int m_minWidth = 60;
+    static constexpr int m_minHeight = 20;
+    static constexpr int m_maxSize = 4096;
+
+    double m_jumpVelocity = 15.0;
+    double m_pipeVelocity = 15.0;
+    double m_gravity = 40.0;
+    int m_width = 120;
+    int m_height = 30;
+
+    // An authored course, looping at its end; random pipes when null.
+    // Not owned: a Level keeps the pipes mapped for as long as it is open.
+    const LevelPipe* m_levelPipes = nullptr;
+    uint64_t m_levelPipeCount = 0;
+};
+
+
+// GameState
+// Everything needed to continue a game: bird, pipes, score, RNG and the
+// place in the level, if there is one.
+// Fixed size and trivially copyable, so a snapshot is a single memcpy.
+//
+struct GameState
+{
+    static constexpr int m_pipeCount = 8;
+
+    double m_verticalVelocity = 0.0;
+    double m_rowDouble = 0.0;
+    size_t m_score = 0;
+    uint64_t m_levelCursor = 0; // The level's next pipe to lay out
+    int m_row = 0;
+    int m_col = 0;
+    bool m_running = false;
+    Random m_random;
+    Pipe m_pipes[m_pipeCount];
+};
+
+static_assert(std::is_trivially_copyable_v<GameState>, "GameState must stay memcpy-able");
+
+
+namespace Simulation
+{
+    void reset(GameState& state, const GameParameters& parameters);
+    void step(GameState& state, const GameParameters& parameters, const bool jump, const double deltaTime);
+    [[nodiscard]] const Pipe* nextPipe(const GameState& state);
+}
@@ -0,0 +1,161 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+std::atomic<bool> Trace::g_enabled(false);
+
+
+namespace
+{
+    constexpr size_t EVENTS_PER_THREAD = 1 << 16;
+
+    struct Event
+    {
+        const char* m_name;
+        int64_t m_start;
+        int64_t m_end;
+    };
+
+    // One per thread, allocated the first time the thread records
+    struct ThreadBuffer
+    {
+        int m_threadId = 0;
+        std::atomic<uint64_t> m_count = 0;
+        std::unique_ptr<Event[]> m_events = std::make_unique<Event[]>(EVENTS_PER_THREAD);
+    };
+
+    std::mutex g_registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_registry;
+    std::string g_path;
+    const auto g_epoch = std::chrono::steady_clock::now();
+
+    ThreadBuffer& threadBuffer(void)
+    {
+        thread_local ThreadBuffer* buffer = nullptr;
+
+        if (buffer == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            g_registry.push_back(std::make_unique<ThreadBuffer>());
+            buffer = g_registry.back().get();
+            buffer->m_threadId = static_cast<int>(g_registry.size());
+        }
+
+        return *buffer;
+    }
+}
+
+
+// Enable
+// Starts recording; flush() writes to the given path.
+//
+void Trace::enable(const std::string& path)
+{
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        g_path = path;
+    }
+
+    g_enabled.store(true, std::memory_order_relaxed);
+}
+
+
+// Disable
+//
+void Trace::disable(void)
+{
+    g_enabled.store(false, std::memory_order_relaxed);
+}
+
+
+// Now
+// Nanoseconds since the trace epoch.
+//
+int64_t Trace::now(void)
+{
+    using namespace std::chrono;
+
+    return duration_cast<nanoseconds>(steady_clock::now() - g_epoch).count();
+}
+
+
+// Record
+// Overwrites the oldest event once the ring is full.
+//
+void Trace::record(const char* name, const int64_t start, const int64_t end)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t count = buffer.m_count.load(std::memory_order_relaxed);
+
+    Event& event = buffer.m_events[count % EVENTS_PER_THREAD];
+    event.m_name = name;
+    event.m_start = start;
+    event.m_end = end;
+
+    buffer.m_count.store(count + 1, std::memory_order_release);
+}
+
+
+// Flush
+// Writes every buffered event as trace-event JSON. Safe to call at any
+// time; events recorded by other threads during the flush may be torn.
+//
+bool Trace::flush(void)
+{
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    if (g_path.empty())
+    {
+        return true;
+    }
+
+    std::ofstream file(g_path, std::ios::trunc);
+
+    if (!file)
+    {
+        std::cout << "Unable to open trace file: " << g_path << std::endl;
+
+        return false;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    char line[256];
+
+    for (const auto& buffer : g_registry)
+    {
+        const uint64_t count = buffer->m_count.load(std::memory_order_acquire);
+        const uint64_t begin = count > EVENTS_PER_THREAD ? count - EVENTS_PER_THREAD : 0;
+
+        for (uint64_t i = begin; i < count; ++i)
+        {
+            const Event& event = buffer->m_events[i % EVENTS_PER_THREAD];
+
+            std::snprintf(
+                line,
+                sizeof(line),
+                "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",",
+                event.m_name,
+                buffer->m_threadId,
+                event.m_start * 1e-3,
+                (event.m_end - event.m_start) * 1e-3);
+
+            file << line;
+            first = false;
+        }
+    }
+
+    file << "\n]}\n";
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+
+// Trace
+// Scoped spans written as Chrome/Perfetto trace-event JSON. Each thread
+// records into its own preallocated ring buffer. While tracing is off a
+// span costs one relaxed load and a branch.
+//
+namespace Trace
+{
+    extern std::atomic<bool> g_enabled;
+
+    void enable(const std::string& path);
+    void disable(void);
+    [[nodiscard]] bool flush(void);
+
+    [[nodiscard]] inline bool enabled(void)
+    {
+        return g_enabled.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] int64_t now(void);
+    void record(const char* name, const int64_t start, const int64_t end);
+
+    class Span
+    {
+    public:
+        Span(void) = delete;
+        Span(const Span& RHS) = delete;
+        Span(Span&& RHS) = delete;
+        Span& operator=(const Span& RHS) = delete;
+        Span& operator=(Span&& RHS) = delete;
+
+        explicit Span(const char* name)
+        : m_name(name),
+          m_start(Trace::enabled() ? Trace::now() : -1)
+        {
+            // Nothing else to do
+        }
+
+        ~Span(void)
+        {
+            if (m_start >= 0)
+            {
+                Trace::record(m_name, m_start, Trace::now());
+            }
+        }
+
+    private:
+        const char* m_name;
+        int64_t m_start;
+    };
+}
+
+#define TRACE_CONCATENATE_INNER(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Span TRACE_CONCATENATE(traceSpan, __LINE__)(name)
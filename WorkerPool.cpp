@@ -0,0 +1,133 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+
+// Constructor
+//
+WorkerPool::WorkerPool(const int threadCount)
+: m_threads(),
+  m_mutex(),
+  m_started(),
+  m_finished(),
+  m_task(nullptr),
+  m_taskCount(0),
+  m_nextTask(0),
+  m_busyThreads(0),
+  m_generation(0),
+  m_stopping(false)
+{
+    // The caller is the first thread
+    const int workers = std::max(threadCount, 1) - 1;
+    m_threads.reserve(workers);
+
+    for (int i = 0; i < workers; ++i)
+    {
+        m_threads.emplace_back([this](void) { this->work(); });
+    }
+}
+
+
+// Destructor
+//
+WorkerPool::~WorkerPool(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_started.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+
+// Run
+//
+void WorkerPool::run(const int taskCount, const std::function<void(int)>& task)
+{
+    if (m_threads.empty() || taskCount <= 1)
+    {
+        for (int i = 0; i < taskCount; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_nextTask.store(0);
+        m_busyThreads = static_cast<int>(m_threads.size());
+        ++m_generation;
+    }
+
+    m_started.notify_all();
+
+    this->drain();
+
+    // Every worker checks in, even one that woke too late to get a task,
+    // so none can still be looking at m_task once this returns
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this](void) { return m_busyThreads == 0; });
+    m_task = nullptr;
+}
+
+
+// Thread Count
+//
+int WorkerPool::threadCount(void) const
+{
+    return static_cast<int>(m_threads.size()) + 1;
+}
+
+
+// Work
+// Worker thread body: sleep until the next run, help drain it, repeat.
+//
+void WorkerPool::work(void)
+{
+    uint64_t seenGeneration = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_started.wait(lock, [&](void) { return m_stopping || m_generation != seenGeneration; });
+
+            if (m_stopping)
+            {
+                return;
+            }
+
+            seenGeneration = m_generation;
+        }
+
+        this->drain();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (--m_busyThreads == 0)
+        {
+            m_finished.notify_one();
+        }
+    }
+}
+
+
+// Drain
+//
+void WorkerPool::drain(void)
+{
+    for (int i = m_nextTask.fetch_add(1); i < m_taskCount; i = m_nextTask.fetch_add(1))
+    {
+        (*m_task)(i);
+    }
+}
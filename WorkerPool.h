@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// WorkerPool
+// Threads started once and kept for the life of the pool, for work that
+// forks and joins every frame, where starting threads each time would
+// cost more than the work. The calling thread takes tasks too, so a pool
+// of one thread runs everything inline.
+//
+class WorkerPool
+{
+public:
+    // Deleted Special Member Functions
+    //
+    WorkerPool(void) = delete;
+    WorkerPool(const WorkerPool& RHS) = delete;
+    WorkerPool(WorkerPool&& RHS) = delete;
+    WorkerPool& operator=(const WorkerPool& RHS) = delete;
+    WorkerPool& operator=(WorkerPool&& RHS) = delete;
+
+    // Constructor
+    //
+    explicit WorkerPool(const int threadCount);
+
+    // Destructor
+    //
+    ~WorkerPool(void);
+
+    // Run
+    // Calls task(i) for every i in [0, taskCount), handing indices out in
+    // order to whichever thread is free, and returns once all are done.
+    //
+    void run(const int taskCount, const std::function<void(int)>& task);
+
+    [[nodiscard]] int threadCount(void) const;
+
+private:
+    void work(void);
+    void drain(void);
+
+    // Private Data Variables
+    //
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_started;
+    std::condition_variable m_finished;
+    const std::function<void(int)>* m_task;
+    int m_taskCount;
+    std::atomic<int> m_nextTask;
+    int m_busyThreads;
+    uint64_t m_generation;
+    bool m_stopping;
+};